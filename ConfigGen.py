@@ -0,0 +1,162 @@
+import argparse
+import csv
+import math
+import os
+import random
+import re
+import sys
+
+# Synthetic _LID config generator for load-scaling runs.
+#
+#	python ConfigGen.py generate --files 50 --sections 100 --out "<mod folder>"
+#	python ConfigGen.py scale --out scaling
+#	python ConfigGen.py curve scaling/*/po3_LockVariations.log > curve.csv
+#
+# Each generated set is dropped into Data, the game is launched to the main menu,
+# and po3_LockVariations.log is copied back next to the set. "curve" collects the
+# profiler summary from those logs into one CSV per release.
+#
+# Legacy (pre-4.0) files are rewritten in place by Manager::Sanitize on the first
+# launch, so a set only exercises Sanitize once. Regenerate it (same --seed gives
+# the same files) before every run that should include the conversion cost.
+
+CONTAINERS = ("Chest01", "Chest02", "ChestNoble01", "ChestDrawer01", "Barrel01", "Safe01", "Strongbox01", "Coffin01", "Urn01", "Satchel01")
+DOORS = ("WRDoor01", "RTDoor02", "WindhelmDoor01", "MarkarthDoor01", "DwemerDoor01", "NordicDoor01", "FarmhouseDoor01", "CaveDoor01")
+FOLDERS = ("Clutter\\Containers", "Clutter\\Upperclass", "Architecture\\Whiterun", "Architecture\\Riften", "Dungeons\\Nordic", "Dungeons\\Dwemer")
+LOCATIONS = ("WhiterunLocation", "RiftenLocation", "WindhelmLocation", "MarkarthLocation", "SolitudeLocation", "0x18A56~Skyrim.esm", "0x18A58~Skyrim.esm", "0x200~Dawnguard.esm")
+TEXTURES = ("Architecture\\Whiterun\\WRWood01.dds", "Clutter\\Containers\\ChestNoble01.dds", "Dungeons\\Nordic\\NorWood01.dds", "Dungeons\\Dwemer\\DwemerMetal01.dds")
+FORMS = ("0x10FD5E~Skyrim.esm", "0xE3F6A~Skyrim.esm", "0x3AC21~Dawnguard.esm", "ChestNoble01", "DweChest01", "WRDoorMainGate01")
+LOCKS = tuple(f"Interface\\Lockpicking\\Variations\\Lock{i:02}.nif" for i in range(32))
+LOCKPICKS = tuple(f"Interface\\Lockpicking\\Variations\\Lockpick{i:02}.nif" for i in range(16))
+SOUNDS = ("CylinderSqueakA", "CylinderSqueakB", "CylinderStop", "CylinderTurn", "PickMovement", "LockpickingUnlock")
+
+def model_pool(a_size):
+	pool = list()
+	for i in range(a_size):
+		name = random.choice(CONTAINERS + DOORS)
+		pool.append(f"Meshes\\{random.choice(FOLDERS)}\\{name}_{i:04}.nif")
+	return pool
+
+def make_section(a_model, a_legacy):
+	lines = list()
+
+	location = random.choice(LOCATIONS) if random.random() < 0.35 else None
+	if a_legacy:
+		lines.append(f"[{a_model}:{location}]" if location else f"[{a_model}]")
+	else:
+		lines.append(f"[{a_model}|{location}]" if location else f"[{a_model}]")
+
+	for keyType in ("Chest", "Door"):
+		if random.random() < 0.3:
+			continue
+		if not a_legacy:
+			for _ in range(random.randint(0, 3)):
+				ids = ",".join(random.sample(TEXTURES + FORMS, random.randint(1, 3)))
+				flags = "|underwater" if random.random() < 0.1 else ""
+				lines.append(f"{keyType}|{ids}{flags} = {random.choice(LOCKS)}")
+		lines.append(f"{keyType} = {random.choice(LOCKS)}")
+
+	if random.random() < 0.5:
+		lines.append(f"Lockpick = {random.choice(LOCKPICKS)}")
+
+	if random.random() < 0.2:
+		for sound in random.sample(SOUNDS, random.randint(1, len(SOUNDS))):
+			lines.append(f"{sound} = UILockpicking{sound}Custom")
+
+	lines.append("")
+	return lines
+
+def make_config(a_path, a_models, a_sections, a_legacy):
+	lines = list()
+	if not a_legacy:
+		lines.append(";4.0.0")
+	lines.append("; generated by ConfigGen.py")
+	lines.append("")
+
+	for _ in range(a_sections):
+		lines.extend(make_section(random.choice(a_models), a_legacy))
+
+	if a_legacy:
+		lines.append("[Underwater]")
+		lines.append(f"Door = {random.choice(LOCKS)}")
+		lines.append(f"Chest = {random.choice(LOCKS)}")
+		lines.append("")
+
+	with open(a_path, "w", encoding="utf-8-sig" if random.random() < 0.5 else "utf-8", newline="\r\n") as out:
+		out.write("\n".join(lines))
+
+def generate(a_out, a_files, a_sections, a_legacy, a_seed):
+	random.seed(a_seed)
+	os.makedirs(a_out, exist_ok=True)
+
+	# fewer unique models than sections, so sections merge across files like real packs
+	models = model_pool(max(1, (a_files * a_sections) // 4))
+	numLegacy = math.ceil(a_files * a_legacy)
+
+	for i in range(a_files):
+		name = f"SyntheticLocks{i:03}_LID.ini"
+		make_config(os.path.join(a_out, name), models, a_sections, i < numLegacy)
+
+	print(f"{a_out}: {a_files} files, {a_files * a_sections} sections, {numLegacy} legacy")
+
+def scale(a_out, a_seed):
+	for files, sections in ((1, 100), (5, 100), (10, 100), (25, 100), (50, 100)):
+		generate(os.path.join(a_out, f"{files:03}x{sections}"), files, sections, 0.1, a_seed)
+
+SPAN = re.compile(r"^\[[\d:]+\] (\w+)\s+(\w+)\s+(\d+)\s+(\d+)\s+(\d+)")
+MEMORY = re.compile(r"^\[[\d:]+\] memory\s+after (.+?)\s+working set [\d.]+MB, private [\d.]+MB, private delta ([-+\d.]+)MB")
+ARENA = re.compile(r"Load arena : peak ([\d.]+)KB in (\d+) blocks, released; retained lock data ([\d.]+)KB")
+SECTIONS = re.compile(r"Merged (\d+) sections into (\d+) lock entries")
+
+def curve(a_logs):
+	spans = ("LoadLocks", "Sanitize", "LoadFile", "AddSections", "MergeSections", "ResolveForms", "InitForms", "InitLockForms")
+	writer = csv.writer(sys.stdout)
+	# data load runs on a worker alongside the game's own loading, so only the arena columns describe it
+	phases = ("ini",)
+	writer.writerow(["log", "sections", "entries"] + [f"{span}_us" for span in spans] + [f"{phase}_private_delta_mb" for phase in phases] + ["arena_peak_kb", "arena_blocks", "retained_kb"])
+
+	for log in a_logs:
+		row = dict()
+		deltas = dict()
+		arena = ("", "", "")
+		sections = entries = 0
+		with open(log, encoding="utf-8", errors="replace") as file:
+			for line in file:
+				if match := SPAN.match(line):
+					row[match.group(2)] = match.group(4)
+				elif match := MEMORY.match(line):
+					deltas[match.group(1)] = match.group(2)
+				elif match := ARENA.search(line):
+					arena = match.groups()
+				elif match := SECTIONS.search(line):
+					sections, entries = match.group(1), match.group(2)
+		writer.writerow([log, sections, entries] + [row.get(span, "") for span in spans] + [deltas.get(phase, "") for phase in phases] + list(arena))
+
+def main():
+	parser = argparse.ArgumentParser(description="Synthetic _LID config generator")
+	commands = parser.add_subparsers(dest="command", required=True)
+
+	gen = commands.add_parser("generate", help="write one config set")
+	gen.add_argument("--out", required=True)
+	gen.add_argument("--files", type=int, default=50)
+	gen.add_argument("--sections", type=int, default=100, help="sections per file")
+	gen.add_argument("--legacy", type=float, default=0.1, help="fraction of pre-4.0 files")
+	gen.add_argument("--seed", type=int, default=0)
+
+	sc = commands.add_parser("scale", help="write config sets of increasing size")
+	sc.add_argument("--out", required=True)
+	sc.add_argument("--seed", type=int, default=0)
+
+	cv = commands.add_parser("curve", help="collect profiler summaries from logs into csv")
+	cv.add_argument("logs", nargs="+")
+
+	args = parser.parse_args()
+	if args.command == "generate":
+		generate(args.out, args.files, args.sections, args.legacy, args.seed)
+	elif args.command == "scale":
+		scale(args.out, args.seed)
+	else:
+		curve(args.logs)
+
+if __name__ == "__main__":
+	main()
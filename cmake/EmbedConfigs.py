@@ -0,0 +1,165 @@
+import os
+import sys
+
+# Generates EmbeddedConfigs.h from a fixed set of _LID inis (EMBED_CONFIGS).
+# Follows the runtime LID::Parse rules, so the tables match what the plugin would read from Data.
+#
+#	python EmbedConfigs.py <output header> <ini>...
+
+def is_space(c):
+	return c in b" \t\r\n"
+
+def is_newline(c):
+	return c in b"\r\n"
+
+# SI_NoCase, on signed chars
+def nocase_key(a_bytes):
+	key = list()
+	for c in a_bytes:
+		if ord("A") <= c <= ord("Z"):
+			c += ord("a") - ord("A")
+		key.append(c - 256 if c >= 0x80 else c)
+	return key
+
+def tokenize(a_text):
+	text = a_text[3:] if a_text.startswith(b"\xef\xbb\xbf") else a_text
+	pos = 0
+	size = len(text)
+
+	sections = list()
+	indices = dict()
+	current = None
+
+	def get_section(a_name):
+		key = tuple(nocase_key(a_name))
+		if key not in indices:
+			indices[key] = len(sections)
+			sections.append((a_name, list()))
+		return indices[key]
+
+	def skip(a_pred):
+		nonlocal pos
+		while pos < size and a_pred(text[pos:pos + 1]):
+			pos += 1
+
+	while True:
+		skip(is_space)
+		if pos >= size:
+			break
+
+		c = text[pos:pos + 1]
+		if c in (b";", b"#"):
+			skip(lambda ch: not is_newline(ch))
+			continue
+
+		if c == b"[":
+			pos += 1
+			skip(is_space)
+			start = pos
+			skip(lambda ch: ch != b"]" and not is_newline(ch))
+			if pos >= size or text[pos:pos + 1] != b"]":
+				continue
+			current = get_section(text[start:pos].rstrip(b" \t\r\n"))
+			skip(lambda ch: not is_newline(ch))
+			continue
+
+		keyStart = pos
+		skip(lambda ch: ch != b"=" and not is_newline(ch))
+		if pos >= size or text[pos:pos + 1] != b"=":
+			continue
+		if keyStart == pos:
+			skip(lambda ch: not is_newline(ch))
+			continue
+
+		key = text[keyStart:pos].rstrip(b" \t\r\n")
+		pos += 1
+		skip(lambda ch: is_space(ch) and not is_newline(ch))
+		valueStart = pos
+		skip(lambda ch: not is_newline(ch))
+
+		if current is None:
+			current = get_section(b"")
+		sections[current][1].append((key, text[valueStart:pos].rstrip(b" \t\r\n")))
+
+	for name, keys in sections:
+		keys.sort(key=lambda kv: nocase_key(kv[0]))
+
+	return sections
+
+def literal(a_bytes):
+	out = ['"']
+	for c in a_bytes:
+		if c == ord("\\"):
+			out.append("\\\\")
+		elif c == ord('"'):
+			out.append('\\"')
+		elif 0x20 <= c < 0x7f:
+			out.append(chr(c))
+		else:
+			out.append(f"\\{c:03o}")
+	out.append('"sv')
+	return "".join(out)
+
+def main():
+	output = sys.argv[1]
+	inputs = sorted(sys.argv[2:], key=lambda path: os.path.basename(path))
+
+	names = list()
+	keys = list()
+	sections = list()
+
+	for index, path in enumerate(inputs):
+		with open(path, "rb") as file:
+			text = file.read()
+
+		firstLine = (text[3:] if text.startswith(b"\xef\xbb\xbf") else text).split(b"\n", 1)[0]
+		if not (firstLine.startswith(b";4.0.0") or firstLine.startswith(b";3.30")):
+			sys.exit(f"{path}: pre-4.0 config, load it once in game so it gets converted before embedding")
+
+		names.append(os.path.basename(path).encode("utf-8"))
+		for name, sectionKeys in tokenize(text):
+			sections.append((index, name, len(keys), len(sectionKeys)))
+			keys.extend(sectionKeys)
+
+	lines = list()
+	lines.append("#pragma once")
+	lines.append("")
+	lines.append("// generated by cmake/EmbedConfigs.py, do not edit")
+	lines.append("namespace Embedded")
+	lines.append("{")
+	lines.append("\tstruct Section")
+	lines.append("\t{")
+	lines.append("\t\tstd::uint32_t    config;")
+	lines.append("\t\tstd::string_view name;")
+	lines.append("\t\tstd::size_t      firstKey;")
+	lines.append("\t\tstd::size_t      numKeys;")
+	lines.append("\t};")
+	lines.append("")
+	lines.append(f"\tinline constexpr std::array<std::string_view, {len(names)}> configs{{")
+	lines.extend(f"\t\t{literal(name)}," for name in names)
+	lines.append("\t};")
+	lines.append("")
+	lines.append(f"\tinline constexpr std::array<LID::Key, {len(keys)}> keys{{ {{")
+	lines.extend(f"\t\t{{ {literal(key)}, {literal(value)} }}," for key, value in keys)
+	lines.append("\t} };")
+	lines.append("")
+	lines.append(f"\tinline constexpr std::array<Section, {len(sections)}> sections{{ {{")
+	lines.extend(f"\t\t{{ {config}, {literal(name)}, {first}, {count} }}," for config, name, first, count in sections)
+	lines.append("\t} };")
+	lines.append("}")
+	lines.append("")
+
+	text = "\n".join(lines)
+	if os.path.exists(output):
+		with open(output, "r", encoding="utf-8") as file:
+			if file.read() == text:
+				return
+
+	os.makedirs(os.path.dirname(output), exist_ok=True)
+	with open(output, "w", encoding="utf-8") as file:
+		file.write(text)
+
+	print(f"Embedded {len(sections)} sections from {len(names)} configs")
+
+if __name__ == "__main__":
+	main()
@@ -1,7 +1,14 @@
 set(headers ${headers}
+	src/API.h
+	src/Arena.h
 	src/Hooks.h
+	src/LIDParser.h
 	src/LockData.h
+	src/LockVariationsAPI.h
 	src/Manager.h
 	src/PCH.h
+	src/Profiler.h
+	src/Serialization.h
+	src/Settings.h
 	src/Util.h
 )
@@ -1,8 +1,14 @@
 set(sources ${sources}
+	src/API.cpp
+	src/Arena.cpp
 	src/Hooks.cpp
+	src/LIDParser.cpp
 	src/LockData.cpp
 	src/Manager.cpp
 	src/PCH.cpp
+	src/Profiler.cpp
+	src/Serialization.cpp
+	src/Settings.cpp
 	src/Util.cpp
 	src/main.cpp
 )
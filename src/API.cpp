@@ -0,0 +1,74 @@
+#include "API.h"
+#include "Manager.h"
+
+namespace API
+{
+	LockVariationsAPI::InterfaceVersion LockVariationsInterface::GetVersion() const
+	{
+		return LockVariationsAPI::InterfaceVersion::kV1;
+	}
+
+	std::size_t LockVariationsInterface::ResolveLocks(RE::TESObjectREFR* const* a_refs, std::size_t a_count, LockVariationsAPI::LockResult* a_results)
+	{
+		if (!a_refs || !a_results) {
+			return 0;
+		}
+
+		const auto manager = Manager::GetSingleton();
+
+		std::size_t numResolved = 0;
+		for (std::size_t i = 0; i < a_count; ++i) {
+			const auto resolution = manager->Resolve(a_refs[i]);
+
+			auto& result = a_results[i];
+			result = {};
+
+			if (const auto modelPath = manager->GetLockModel(resolution)) {
+				result.lockModel = modelPath->c_str();
+			}
+			if (const auto modelPath = manager->GetLockpickModel(resolution)) {
+				result.lockpickModel = modelPath->c_str();
+			}
+			if (const auto sounds = manager->GetSounds(resolution)) {
+				result.sounds = {
+					sounds->UILockpickingCylinderSqueakA.c_str(),
+					sounds->UILockpickingCylinderSqueakB.c_str(),
+					sounds->UILockpickingCylinderStop.c_str(),
+					sounds->UILockpickingCylinderTurn.c_str(),
+					sounds->UILockpickingPickMovement.c_str(),
+					sounds->UILockpickingUnlock.c_str()
+				};
+			}
+
+			if (result.lockModel || result.lockpickModel) {
+				++numResolved;
+			}
+		}
+
+		return numResolved;
+	}
+
+	void MessageHandler(SKSE::MessagingInterface::Message* a_message)
+	{
+		if (a_message->type != LockVariationsAPI::kRequestInterface || !a_message->data || a_message->dataLen < sizeof(LockVariationsAPI::InterfaceRequest)) {
+			return;
+		}
+
+		auto request = static_cast<LockVariationsAPI::InterfaceRequest*>(a_message->data);
+		switch (request->interfaceVersion) {
+		case LockVariationsAPI::InterfaceVersion::kV1:
+			request->api = static_cast<LockVariationsAPI::IVLockVariations1*>(LockVariationsInterface::GetSingleton());
+			logger::info("Provided API v1 to {}", a_message->sender ? a_message->sender : "unknown plugin");
+			break;
+		default:
+			logger::warn("{} requested unknown API version {}", a_message->sender ? a_message->sender : "unknown plugin", std::to_underlying(request->interfaceVersion));
+			break;
+		}
+	}
+
+	void Register()
+	{
+		// listen to every sender, plugins dispatch their requests directly to us
+		SKSE::GetMessagingInterface()->RegisterListener(nullptr, MessageHandler);
+	}
+}
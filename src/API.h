@@ -0,0 +1,21 @@
+#pragma once
+
+#include "LockVariationsAPI.h"
+
+namespace API
+{
+	class LockVariationsInterface : public LockVariationsAPI::IVLockVariations1
+	{
+	public:
+		[[nodiscard]] LockVariationsAPI::InterfaceVersion GetVersion() const override;
+		std::size_t                                       ResolveLocks(RE::TESObjectREFR* const* a_refs, std::size_t a_count, LockVariationsAPI::LockResult* a_results) override;
+
+		static LockVariationsInterface* GetSingleton()
+		{
+			static LockVariationsInterface singleton;
+			return &singleton;
+		}
+	};
+
+	void Register();
+}
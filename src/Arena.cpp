@@ -0,0 +1,90 @@
+#include "Arena.h"
+
+namespace Arena
+{
+	namespace detail
+	{
+		// tracks what the arena pulls from the heap
+		class CountingResource : public std::pmr::memory_resource
+		{
+		public:
+			[[nodiscard]] std::size_t peak() const { return peakBytes; }
+			[[nodiscard]] std::size_t blocks() const { return numBlocks; }
+
+		private:
+			void* do_allocate(std::size_t a_bytes, std::size_t a_alignment) override
+			{
+				auto ptr = std::pmr::new_delete_resource()->allocate(a_bytes, a_alignment);
+				currentBytes += a_bytes;
+				peakBytes = std::max(peakBytes, currentBytes);
+				++numBlocks;
+				return ptr;
+			}
+
+			void do_deallocate(void* a_ptr, std::size_t a_bytes, std::size_t a_alignment) override
+			{
+				std::pmr::new_delete_resource()->deallocate(a_ptr, a_bytes, a_alignment);
+				currentBytes -= a_bytes;
+			}
+
+			[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& a_other) const noexcept override
+			{
+				return this == &a_other;
+			}
+
+			// members
+			std::size_t currentBytes{};
+			std::size_t peakBytes{};
+			std::size_t numBlocks{};
+		};
+
+		struct LoadArena
+		{
+			static constexpr std::size_t initialSize = 256 * 1024;
+
+			// members
+			CountingResource                    upstream{};
+			std::pmr::monotonic_buffer_resource buffer{ initialSize, &upstream };
+		};
+
+		std::unique_ptr<LoadArena>   arena{};
+		std::atomic<std::thread::id> owner{};
+	}
+
+	void Begin()
+	{
+		if (!detail::arena) {
+			detail::arena = std::make_unique<detail::LoadArena>();
+			detail::owner = std::this_thread::get_id();
+		}
+	}
+
+	void Release(std::size_t a_retainedBytes)
+	{
+		if (!detail::arena) {
+			return;
+		}
+
+		const auto peak = detail::arena->upstream.peak();
+		const auto blocks = detail::arena->upstream.blocks();
+
+		detail::owner = std::thread::id();
+		detail::arena.reset();
+
+		logger::info("Load arena : peak {:.1f}KB in {} blocks, released; retained lock data {:.1f}KB", peak / 1024.0, blocks, a_retainedBytes / 1024.0);
+	}
+
+	std::pmr::memory_resource* Get()
+	{
+		// owner is only ever set while the arena exists
+		if (detail::owner == std::this_thread::get_id() && detail::arena) {
+			return &detail::arena->buffer;
+		}
+		return std::pmr::get_default_resource();
+	}
+
+	void SetOwner(std::thread::id a_id)
+	{
+		detail::owner = a_id;
+	}
+}
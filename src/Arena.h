@@ -0,0 +1,14 @@
+#pragma once
+
+// monotonic arena for load-time temporaries, released wholesale once the lock data is frozen
+namespace Arena
+{
+	void Begin();
+	void Release(std::size_t a_retainedBytes);
+
+	// the arena while loading (on the loading thread), the default resource otherwise
+	std::pmr::memory_resource* Get();
+
+	// hand the arena over to another thread, loading is never concurrent
+	void SetOwner(std::thread::id a_id);
+}
@@ -0,0 +1,236 @@
+#include "LIDParser.h"
+
+#include <Windows.h>
+
+namespace LID
+{
+	namespace detail
+	{
+		bool is_space(char a_ch) { return a_ch == ' ' || a_ch == '\t' || a_ch == '\r' || a_ch == '\n'; }
+		bool is_newline(char a_ch) { return a_ch == '\r' || a_ch == '\n'; }
+		bool is_comment(char a_ch) { return a_ch == ';' || a_ch == '#'; }
+
+		char to_lower(char a_ch) { return a_ch >= 'A' && a_ch <= 'Z' ? static_cast<char>(a_ch - 'A' + 'a') : a_ch; }
+
+		// SI_NoCase
+		int compare_nocase(std::string_view a_lhs, std::string_view a_rhs)
+		{
+			const auto size = std::min(a_lhs.size(), a_rhs.size());
+			for (std::size_t i = 0; i < size; ++i) {
+				if (const auto diff = to_lower(a_lhs[i]) - to_lower(a_rhs[i]); diff != 0) {
+					return diff;
+				}
+			}
+			if (a_lhs.size() != a_rhs.size()) {
+				return a_lhs.size() < a_rhs.size() ? -1 : 1;
+			}
+			return 0;
+		}
+
+		struct less_nocase
+		{
+			bool operator()(std::string_view a_lhs, std::string_view a_rhs) const { return compare_nocase(a_lhs, a_rhs) < 0; }
+		};
+
+		std::string_view trim_right(std::string_view a_str)
+		{
+			while (!a_str.empty() && is_space(a_str.back())) {
+				a_str.remove_suffix(1);
+			}
+			return a_str;
+		}
+
+		class Tokenizer
+		{
+		public:
+			Tokenizer(std::string_view a_text, std::pmr::memory_resource* a_resource) :
+				text(a_text),
+				resource(a_resource)
+			{
+				if (text.starts_with("\xEF\xBB\xBF"sv)) {
+					pos = 3;
+				}
+			}
+
+			std::pmr::vector<Section> Parse()
+			{
+				std::pmr::vector<Section>                                  sections(resource);
+				std::pmr::map<std::string_view, std::size_t, less_nocase> indices(resource);
+				std::optional<std::size_t>                                 current;
+
+				const auto get_section = [&](std::string_view a_name) {
+					const auto [it, inserted] = indices.try_emplace(a_name, sections.size());
+					if (inserted) {
+						sections.push_back({ a_name, std::pmr::vector<Key>(resource) });
+					}
+					return it->second;
+				};
+
+				while (true) {
+					skip([](char a_ch) { return is_space(a_ch); });
+					if (at_end()) {
+						break;
+					}
+
+					if (is_comment(text[pos])) {
+						skip_line();
+						continue;
+					}
+
+					if (text[pos] == '[') {
+						++pos;
+						skip([](char a_ch) { return is_space(a_ch); });
+
+						const auto start = pos;
+						skip([](char a_ch) { return a_ch != ']' && !is_newline(a_ch); });
+						if (at_end() || text[pos] != ']') {
+							continue;
+						}
+
+						current = get_section(trim_right(text.substr(start, pos - start)));
+						skip_line();
+						continue;
+					}
+
+					const auto keyStart = pos;
+					skip([](char a_ch) { return a_ch != '=' && !is_newline(a_ch); });
+					if (at_end() || text[pos] != '=') {
+						continue;
+					}
+					if (keyStart == pos) {
+						skip_line();
+						continue;
+					}
+
+					const auto key = trim_right(text.substr(keyStart, pos - keyStart));
+
+					++pos;
+					skip([](char a_ch) { return is_space(a_ch) && !is_newline(a_ch); });
+
+					const auto valueStart = pos;
+					skip_line();
+
+					if (!current) {
+						current = get_section(""sv);
+					}
+					sections[*current].keys.push_back({ key, trim_right(text.substr(valueStart, pos - valueStart)) });
+				}
+
+				for (auto& section : sections) {
+					std::ranges::stable_sort(section.keys, [](const Key& a_lhs, const Key& a_rhs) {
+						return less_nocase{}(a_lhs.key, a_rhs.key);
+					});
+				}
+
+				return sections;
+			}
+
+		private:
+			[[nodiscard]] bool at_end() const { return pos >= text.size(); }
+
+			template <class Func>
+			void skip(Func a_pred)
+			{
+				while (!at_end() && a_pred(text[pos])) {
+					++pos;
+				}
+			}
+
+			void skip_line()
+			{
+				skip([](char a_ch) { return !is_newline(a_ch); });
+			}
+
+			// members
+			std::string_view           text;
+			std::pmr::memory_resource* resource;
+			std::size_t                pos{ 0 };
+		};
+	}
+
+	MappedFile::MappedFile(const std::string& a_path)
+	{
+		file = ::CreateFileA(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			file = nullptr;
+			return;
+		}
+
+		LARGE_INTEGER fileSize{};
+		if (!::GetFileSizeEx(file, &fileSize)) {
+			return;
+		}
+
+		size = static_cast<std::size_t>(fileSize.QuadPart);
+		if (size == 0) {  // empty files can't be mapped
+			open = true;
+			return;
+		}
+
+		mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			return;
+		}
+
+		data = static_cast<const char*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		open = data != nullptr;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data) {
+			::UnmapViewOfFile(data);
+		}
+		if (mapping) {
+			::CloseHandle(mapping);
+		}
+		if (file) {
+			::CloseHandle(file);
+		}
+	}
+
+	std::pmr::vector<Section> Parse(std::string_view a_text, std::pmr::memory_resource* a_resource)
+	{
+		return detail::Tokenizer(a_text, a_resource).Parse();
+	}
+
+	std::pmr::vector<Section> Parse(CSimpleIniA& a_ini)
+	{
+		CSimpleIniA::TNamesDepend names;
+		a_ini.GetAllSections(names);
+		names.sort(CSimpleIniA::Entry::LoadOrder());
+
+		std::pmr::vector<Section> sections;
+		sections.reserve(names.size());
+
+		for (auto& name : names) {
+			auto& section = sections.emplace_back(Section{ name.pItem, {} });
+			if (const auto values = a_ini.GetSection(name.pItem)) {
+				for (auto& [key, value] : *values) {
+					section.keys.push_back({ key.pItem, value });
+				}
+			}
+		}
+
+		return sections;
+	}
+
+	std::optional<std::string_view> GetValue(const Section& a_section, std::string_view a_key)
+	{
+		const auto it = std::ranges::lower_bound(a_section.keys, a_key, detail::less_nocase{}, &Key::key);
+		if (it != a_section.keys.end() && detail::compare_nocase(it->key, a_key) == 0) {
+			return it->value;
+		}
+		return std::nullopt;
+	}
+
+	bool operator==(const Key& a_lhs, const Key& a_rhs)
+	{
+		return a_lhs.key == a_rhs.key && a_lhs.value == a_rhs.value;
+	}
+
+	bool operator==(const Section& a_lhs, const Section& a_rhs)
+	{
+		return a_lhs.name == a_rhs.name && std::ranges::equal(a_lhs.keys, a_rhs.keys);
+	}
+}
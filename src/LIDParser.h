@@ -0,0 +1,51 @@
+#pragma once
+
+// purpose-built reader for _LID configs, tokenizing into views over a memory mapped file
+namespace LID
+{
+	struct Key
+	{
+		std::string_view key;
+		std::string_view value;
+	};
+
+	struct Section
+	{
+		std::string_view      name;
+		std::pmr::vector<Key> keys;  // sorted case-insensitively, duplicates kept in file order (as CSimpleIni multi-key)
+	};
+
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& a_path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) = delete;
+
+		[[nodiscard]] bool             IsOpen() const { return open; }
+		[[nodiscard]] std::string_view View() const { return { data, size }; }
+
+	private:
+		// members
+		void*       file{};
+		void*       mapping{};
+		const char* data{};
+		std::size_t size{};
+		bool        open{ false };
+	};
+
+	// sections in load order, same-named sections merged like CSimpleIni
+	std::pmr::vector<Section> Parse(std::string_view a_text, std::pmr::memory_resource* a_resource = std::pmr::get_default_resource());
+	std::pmr::vector<Section> Parse(CSimpleIniA& a_ini);
+
+	// first value for a case-insensitive key
+	std::optional<std::string_view> GetValue(const Section& a_section, std::string_view a_key);
+
+	bool operator==(const Key& a_lhs, const Key& a_rhs);
+	bool operator==(const Section& a_lhs, const Section& a_rhs);
+}
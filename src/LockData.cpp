@@ -1,14 +1,33 @@
 #include "LockData.h"
+#include "Arena.h"
 
 namespace Lock
 {
-	Type::Type(const std::string& a_section)
+	namespace detail
+	{
+		std::size_t heap_size(const std::string& a_str)
+		{
+			// short strings live inside the object
+			const auto data = reinterpret_cast<std::uintptr_t>(a_str.data());
+			const auto self = reinterpret_cast<std::uintptr_t>(&a_str);
+			return data >= self && data < self + sizeof(a_str) ? 0 : a_str.capacity() + 1;
+		}
+
+		template <class T>
+		std::size_t heap_size(const std::vector<T>& a_vec)
+		{
+			return a_vec.capacity() * sizeof(T);
+		}
+	}
+
+	Type::Type(std::string_view a_section) :
+		section(a_section)
 	{
 		if (a_section.empty()) {
 			return;
 		}
 
-		auto lockTypeStrs = string::split(a_section, "|");
+		const auto lockTypeStrs = util::split(a_section, "|");
 
 		modelPath = util::SanitizeModel(lockTypeStrs[0]);
 		if (lockTypeStrs.size() > 1) {
@@ -16,10 +35,23 @@ namespace Lock
 		}
 	}
 
-	void Type::InitLocation()
+	Type::Type(std::string_view a_section, std::string_view a_modelPath, std::string_view a_locationStr) :
+		section(a_section),
+		modelPath(a_modelPath),
+		locationStr(a_locationStr)
+	{}
+
+	void Type::CollectForms(util::FormIDResolver& a_resolver) const
+	{
+		if (!locationStr.empty()) {
+			a_resolver.Add(locationStr);
+		}
+	}
+
+	void Type::InitLocation(const util::FormIDResolver& a_resolver)
 	{
 		if (!locationStr.empty()) {
-			locationID = util::GetFormID(locationStr);
+			locationID = a_resolver.GetFormID(locationStr);
 		}
 	}
 
@@ -37,39 +69,58 @@ namespace Lock
 		return true;
 	}
 
-	Sound::Sound(CSimpleIniA& a_ini, const std::string& a_section)
+	bool Type::Covers(const Type& a_other) const
 	{
-		if (a_section.empty()) {
+		if (!modelPath.empty() && !a_other.modelPath.contains(modelPath)) {
+			return false;
+		}
+		// unresolved locations are never checked
+		return locationID == 0 || locationID == a_other.locationID;
+	}
+
+	Sound::Sound(const LID::Section& a_section)
+	{
+		if (a_section.name.empty()) {
 			return;
 		}
 
-		ini::get_value(a_ini, UILockpickingCylinderSqueakA, a_section.c_str(), "CylinderSqueakA");
-		ini::get_value(a_ini, UILockpickingCylinderSqueakB, a_section.c_str(), "CylinderSqueakB");
-		ini::get_value(a_ini, UILockpickingCylinderStop, a_section.c_str(), "CylinderStop");
-		ini::get_value(a_ini, UILockpickingCylinderTurn, a_section.c_str(), "CylinderTurn");
-		ini::get_value(a_ini, UILockpickingPickMovement, a_section.c_str(), "PickMovement");
-		ini::get_value(a_ini, UILockpickingUnlock, a_section.c_str(), "LockpickingUnlock");
+		const auto get_value = [&](std::string& a_value, std::string_view a_key) {
+			if (const auto value = LID::GetValue(a_section, a_key)) {
+				a_value = *value;
+			}
+		};
+
+		get_value(UILockpickingCylinderSqueakA, "CylinderSqueakA");
+		get_value(UILockpickingCylinderSqueakB, "CylinderSqueakB");
+		get_value(UILockpickingCylinderStop, "CylinderStop");
+		get_value(UILockpickingCylinderTurn, "CylinderTurn");
+		get_value(UILockpickingPickMovement, "PickMovement");
+		get_value(UILockpickingUnlock, "LockpickingUnlock");
 	}
 
-	Model::Condition::Condition(const std::string& a_id, const std::string& a_flags)
+	Model::Condition::Condition(std::string_view a_id, std::string_view a_flags)
 	{
-		if (dist::is_valid_entry(a_id)) {
-			auto vec = string::split(a_id, ",");
-			for (auto& id : vec) {
-				ids.push_back(id);
+		if (util::is_valid_entry(a_id)) {
+			for (const auto& id : util::split(a_id, ",")) {
+				ids.emplace_back(std::string(id));
 			}
 		}
-		if (dist::is_valid_entry(a_flags)) {
-			if (a_flags == "underwater") {
-				flags = Flags::kUnderwater;
-			}
+		if (a_flags == "underwater") {
+			flags = Flags::kUnderwater;
+		}
+	}
+
+	void Model::Condition::CollectForms(util::FormIDResolver& a_resolver) const
+	{
+		for (auto& id : ids) {
+			a_resolver.Add(std::get<std::string>(id));
 		}
 	}
 
-	void Model::Condition::InitForms()
+	void Model::Condition::InitForms(const util::FormIDResolver& a_resolver)
 	{
 		for (auto& id : ids) {
-			id = util::GetFormIDStr(std::get<std::string>(id), true);
+			id = a_resolver.GetFormIDStr(std::get<std::string>(id), true);
 		}
 	}
 
@@ -91,6 +142,7 @@ namespace Lock
 		});
 
 		if (flags == Flags::kUnderwater) {
+			a_checker.dynamic = true;
 			result = RE::TESWaterSystem::GetSingleton()->playerUnderwater;
 		}
 
@@ -132,21 +184,30 @@ namespace Lock
 		return false;
 	}
 
-	Model::Model(const std::string& key, const std::string& entry) :
-		model(entry)
+	Model::Model(std::string_view a_key, std::string_view a_entry, std::uint32_t a_config) :
+		model(a_entry),
+		key(a_key),
+		config(a_config)
 	{
-		auto vec = string::split(key, "|");
+		const auto vec = util::split(a_key, "|");
 		if (vec.size() > 1) {
 			condition = Condition(
 				vec[1],
-				vec.size() > 2 ? vec[2] : std::string());
+				vec.size() > 2 ? vec[2] : std::string_view());
 		}
 	}
 
-	void Model::InitForms()
+	void Model::CollectForms(util::FormIDResolver& a_resolver) const
 	{
 		if (condition) {
-			condition->InitForms();
+			condition->CollectForms(a_resolver);
+		}
+	}
+
+	void Model::InitForms(const util::FormIDResolver& a_resolver)
+	{
+		if (condition) {
+			condition->InitForms(a_resolver);
 		}
 	}
 
@@ -164,58 +225,95 @@ namespace Lock
 		}
 	}
 
-	std::tuple<bool, std::string, Sound> ConditionChecker::IsValid(const Variant& a_variant, bool a_isLockPick) const
+	const Model* ConditionChecker::GetMatch(const Variant& a_variant, ModelType a_type) const
 	{
-		if (a_variant.type.IsValid(*this)) {
-			const auto& models = a_isLockPick ? a_variant.lockpicks : GetModels(a_variant);
-			for (const auto& model : models) {
-				if (!model.condition || model.condition->IsValid(*this)) {
-					if (model.model != (a_isLockPick ? defaultLockPick : defaultLock)) {
-						return { true, model.model, a_variant.sounds };
+		const auto defaultModel = a_type == ModelType::kLockpick ? defaultLockPick : defaultLock;
+		for (const auto& model : a_variant.GetModels(a_type)) {
+			if (telemetry) {
+				Telemetry::Increment(model.telemetry.evaluated);
+			}
+			if (!model.condition || model.condition->IsValid(*this)) {
+				if (model.model != defaultModel) {
+					if (telemetry) {
+						Telemetry::Increment(model.telemetry.matched);
 					}
+					return &model;
 				}
+			} else if (telemetry) {
+				Telemetry::Increment(model.telemetry.rejectedByCondition);
 			}
 		}
-		return { false, "", Sound() };
+		return nullptr;
 	}
 
-	const std::vector<Model>& ConditionChecker::GetModels(const Variant& a_variant) const
+	ModelType ConditionChecker::GetLockType() const
 	{
 		switch (base->GetFormType()) {
 		case RE::FormType::Door:
-			return a_variant.doors;
+			return ModelType::kDoor;
+		default:
+			return ModelType::kChest;
+		}
+	}
+
+	Variant::Variant(const LID::Section& a_section, std::uint32_t a_config) :
+		Variant(Type(a_section.name), a_section, a_config)
+	{}
+
+	Variant::Variant(Type&& a_type, const LID::Section& a_section, std::uint32_t a_config) :
+		type(std::move(a_type)),
+		sounds(a_section),
+		config(a_config)
+	{
+		AddModels(a_section, a_config);
+	}
+
+	const std::vector<Model>& Variant::GetModels(ModelType a_type) const
+	{
+		switch (a_type) {
+		case ModelType::kDoor:
+			return doors;
+		case ModelType::kLockpick:
+			return lockpicks;
 		default:
-			return a_variant.chests;
+			return chests;
 		}
 	}
 
-	Variant::Variant(CSimpleIniA& a_ini, const std::string& a_section) :
-		type(a_section),
-		sounds(a_ini, a_section)
+	std::vector<Model>& Variant::GetModels(ModelType a_type)
 	{
-		AddModels(a_ini, a_section);
+		return const_cast<std::vector<Model>&>(std::as_const(*this).GetModels(a_type));
 	}
 
-	void Variant::AddModels(CSimpleIniA& a_ini, const std::string& a_section)
+	void Variant::AddModels(const LID::Section& a_section, std::uint32_t a_config)
 	{
-		if (auto values = a_ini.GetSection(a_section.c_str()); values && !values->empty()) {
-			for (auto& [key, entry] : *values) {
-				AddModels(key.pItem, entry);
-			}
+		for (auto& [key, entry] : a_section.keys) {
+			AddModels(key, entry, a_config);
 		}
 	}
 
-	void Variant::AddModels(const std::string& a_key, const std::string& a_entry)
+	void Variant::AddModels(std::string_view a_key, std::string_view a_entry, std::uint32_t a_config)
 	{
 		if (a_key.starts_with("Chest")) {
-			chests.emplace_back(a_key, a_entry);
+			chests.emplace_back(a_key, a_entry, a_config);
 		} else if (a_key.starts_with("Door")) {
-			doors.emplace_back(a_key, a_entry);
+			doors.emplace_back(a_key, a_entry, a_config);
 		} else if (a_key.starts_with("Lockpick") && a_key != "LockpickingUnlock") {
-			lockpicks.emplace_back(a_key, a_entry);
+			lockpicks.emplace_back(a_key, a_entry, a_config);
 		}
 	}
 
+	void Variant::MergeModels(Variant&& a_other)
+	{
+		const auto append = [](std::vector<Model>& a_dst, std::vector<Model>& a_src) {
+			a_dst.insert(a_dst.end(), std::make_move_iterator(a_src.begin()), std::make_move_iterator(a_src.end()));
+		};
+
+		append(chests, a_other.chests);
+		append(doors, a_other.doors);
+		append(lockpicks, a_other.lockpicks);
+	}
+
 	void Variant::SortModels()
 	{
 		//shift conditional models to top
@@ -232,14 +330,111 @@ namespace Lock
 		});
 	}
 
-	void Variant::InitForms()
+	void Variant::CollectForms(util::FormIDResolver& a_resolver)
 	{
-		type.InitLocation();
+		type.CollectForms(a_resolver);
 
 		ForEachModelType([&](std::vector<Lock::Model>& models) {
 			for (auto& model : models) {
-				model.InitForms();
+				model.CollectForms(a_resolver);
 			}
 		});
 	}
+
+	void Variant::InitForms(const util::FormIDResolver& a_resolver)
+	{
+		type.InitLocation(a_resolver);
+
+		ForEachModelType([&](std::vector<Lock::Model>& models) {
+			for (auto& model : models) {
+				model.InitForms(a_resolver);
+			}
+		});
+	}
+
+	std::size_t Variant::GetHeapSize() const
+	{
+		std::size_t size = detail::heap_size(type.section) + detail::heap_size(type.modelPath) + detail::heap_size(type.locationStr);
+
+		for (const auto modelType : { ModelType::kChest, ModelType::kDoor, ModelType::kLockpick }) {
+			const auto& models = GetModels(modelType);
+			size += detail::heap_size(models);
+			for (auto& model : models) {
+				size += detail::heap_size(model.model) + detail::heap_size(model.key);
+				if (model.condition) {
+					size += detail::heap_size(model.condition->ids);
+					for (auto& id : model.condition->ids) {
+						if (const auto path = std::get_if<std::string>(&id)) {
+							size += detail::heap_size(*path);
+						}
+					}
+				}
+			}
+		}
+
+		size += detail::heap_size(sounds.UILockpickingCylinderSqueakA) + detail::heap_size(sounds.UILockpickingCylinderSqueakB) +
+		        detail::heap_size(sounds.UILockpickingCylinderStop) + detail::heap_size(sounds.UILockpickingCylinderTurn) +
+		        detail::heap_size(sounds.UILockpickingPickMovement) + detail::heap_size(sounds.UILockpickingUnlock);
+
+		return size;
+	}
+
+	VariantBuilder::VariantBuilder() :
+		text(Arena::Get()),
+		entries(Arena::Get())
+	{}
+
+	std::string_view VariantBuilder::Copy(std::string_view a_str)
+	{
+		if (a_str.empty()) {
+			return {};
+		}
+		const auto data = static_cast<char*>(text.allocate(a_str.size(), alignof(char)));
+		std::ranges::copy(a_str, data);
+		return { data, a_str.size() };
+	}
+
+	void VariantBuilder::Add(const LID::Section& a_section, std::uint32_t a_config)
+	{
+		std::pmr::vector<LID::Key> keys(&text);
+		keys.reserve(a_section.keys.size());
+		for (auto& [key, value] : a_section.keys) {
+			keys.push_back({ Copy(key), Copy(value) });
+		}
+
+		const auto name = Copy(a_section.name);
+		const auto lockTypeStrs = util::split(name, "|");
+
+		entries.push_back({ { name, std::move(keys) },
+			util::SanitizeModel(lockTypeStrs[0], &text),
+			lockTypeStrs.size() > 1 ? lockTypeStrs[1] : std::string_view(),
+			a_config });
+	}
+
+	std::vector<Variant> VariantBuilder::Build()
+	{
+		const auto less = [](const Entry& a_lhs, const Entry& a_rhs) {
+			return Type::Less(a_lhs.modelPath, a_lhs.locationStr, a_rhs.modelPath, a_rhs.locationStr);
+		};
+
+		// stable, so the first section in load order keeps its type/sounds and later duplicates append models in order
+		std::ranges::stable_sort(entries, less);
+
+		std::vector<Variant> result;
+		result.reserve(entries.size());  // trimmed below, merged duplicates make this an upper bound
+
+		for (std::size_t i = 0; i < entries.size(); ++i) {
+			auto& entry = entries[i];
+			if (i > 0 && !less(entries[i - 1], entry)) {
+				result.back().AddModels(entry.section, entry.config);
+			} else {
+				result.emplace_back(Type(entry.section.name, entry.modelPath, entry.locationStr), entry.section, entry.config);
+			}
+		}
+
+		entries.clear();
+
+		result.shrink_to_fit();
+		return result;
+	}
 }
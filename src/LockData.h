@@ -1,5 +1,6 @@
 #pragma once
 
+#include "LIDParser.h"
 #include "Util.h"
 
 namespace Lock
@@ -10,29 +11,59 @@ namespace Lock
 
 	struct ConditionChecker;
 
+	// optional match counters, for finding config entries that never apply
+	struct Telemetry
+	{
+		static void Increment(std::uint32_t& a_counter)
+		{
+			std::atomic_ref(a_counter).fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static std::uint32_t Load(std::uint32_t& a_counter)
+		{
+			return std::atomic_ref(a_counter).load(std::memory_order_relaxed);
+		}
+
+		// members
+		std::uint32_t evaluated{};
+		std::uint32_t rejectedByType{};
+		std::uint32_t rejectedByCondition{};
+		std::uint32_t notTried{};  // variant type matched, but it had no models for the slots still open
+		std::uint32_t matched{};
+	};
+
 	struct Type
 	{
 		Type() = default;
-		Type(const std::string& a_section);
+		Type(std::string_view a_section);
+		Type(std::string_view a_section, std::string_view a_modelPath, std::string_view a_locationStr);
 
-		bool operator<(const Type& a_rhs) const
-		{	
-			if (modelPath.empty() && !a_rhs.modelPath.empty()) {
+		bool operator<(const Type& a_rhs) const { return Less(modelPath, locationStr, a_rhs.modelPath, a_rhs.locationStr); }
+
+		// the sort order on (sanitized model path, location), also used on VariantBuilder's arena copies
+		[[nodiscard]] static bool Less(std::string_view a_lhsModel, std::string_view a_lhsLocation, std::string_view a_rhsModel, std::string_view a_rhsLocation)
+		{
+			if (a_lhsModel.empty() && !a_rhsModel.empty()) {
 				return false;
 			}
-			if (!modelPath.empty() && a_rhs.modelPath.empty()) {
+			if (!a_lhsModel.empty() && a_rhsModel.empty()) {
 				return true;
 			}
-			if (modelPath != a_rhs.modelPath) {
-				return modelPath < a_rhs.modelPath;
+			if (a_lhsModel != a_rhsModel) {
+				return a_lhsModel < a_rhsModel;
 			}
-			return locationStr > a_rhs.locationStr;  //biggest to smallest/empty
+			return a_lhsLocation > a_rhsLocation;  //biggest to smallest/empty
 		}
 
-		void               InitLocation();
+		void               CollectForms(util::FormIDResolver& a_resolver) const;
+		void               InitLocation(const util::FormIDResolver& a_resolver);
 		[[nodiscard]] bool IsValid(const ConditionChecker& a_checker) const;
 
+		// valid for every reference a_other is valid for
+		[[nodiscard]] bool Covers(const Type& a_other) const;
+
 		// members
+		std::string section{};  // as written in the ini
 		std::string modelPath{};
 
 		RE::FormID  locationID{};
@@ -42,7 +73,7 @@ namespace Lock
 	struct Sound
 	{
 		Sound() = default;
-		Sound(CSimpleIniA& a_ini, const std::string& a_section);
+		Sound(const LID::Section& a_section);
 
 		// members
 		std::string UILockpickingCylinderSqueakA{ "UILockpickingCylinderSqueakA" };
@@ -58,7 +89,7 @@ namespace Lock
 		Model() = default;
 		Model(std::string_view a_model) :
 			model(a_model){};
-		Model(const std::string& key, const std::string& entry);
+		Model(std::string_view a_key, std::string_view a_entry, std::uint32_t a_config);
 
 		struct Condition
 		{
@@ -68,11 +99,15 @@ namespace Lock
 				kUnderwater = 1
 			};
 
-			Condition(const std::string& a_id, const std::string& a_flags);
+			Condition(std::string_view a_id, std::string_view a_flags);
 
-			void               InitForms();
+			void               CollectForms(util::FormIDResolver& a_resolver) const;
+			void               InitForms(const util::FormIDResolver& a_resolver);
 			[[nodiscard]] bool IsValid(const ConditionChecker& a_checker) const;
 
+			// no ids and no flags, IsValid can only fail
+			[[nodiscard]] bool IsNeverValid() const { return ids.empty() && flags == Flags::kNone; }
+
 			[[nodiscard]] static bool IsValidImpl(const ConditionChecker& a_checker, RE::FormID a_formID);
 			[[nodiscard]] static bool IsValidImpl(const ConditionChecker& a_checker, const std::string& a_path);
 
@@ -81,21 +116,42 @@ namespace Lock
 			Flags                  flags{ Flags::kNone };
 		};
 
-		void InitForms();
+		void CollectForms(util::FormIDResolver& a_resolver) const;
+		void InitForms(const util::FormIDResolver& a_resolver);
 
 		// members
 		std::optional<Condition> condition{};
 		std::string              model{ defaultLock };
+		std::string              key{};     // as written in the ini
+		std::uint32_t            config{};  // ini index
+		mutable Telemetry        telemetry{};
+	};
+
+	enum class ModelType : std::uint8_t
+	{
+		kChest = 0,
+		kDoor,
+		kLockpick
 	};
 
 	struct Variant
 	{
-		Variant(CSimpleIniA& a_ini, const std::string& a_section);
+		Variant(const LID::Section& a_section, std::uint32_t a_config);
+		Variant(Type&& a_type, const LID::Section& a_section, std::uint32_t a_config);
 
-		void AddModels(CSimpleIniA& a_ini, const std::string& a_section);
-		void AddModels(const std::string& a_key, const std::string& a_entry);
+		[[nodiscard]] const std::vector<Model>& GetModels(ModelType a_type) const;
+		[[nodiscard]] std::vector<Model>&       GetModels(ModelType a_type);
+		[[nodiscard]] bool                      HasModels() const { return !chests.empty() || !doors.empty() || !lockpicks.empty(); }
+
+		void AddModels(const LID::Section& a_section, std::uint32_t a_config);
+		void AddModels(std::string_view a_key, std::string_view a_entry, std::uint32_t a_config);
+		void MergeModels(Variant&& a_other);
 		void SortModels();
-		void InitForms();
+		void CollectForms(util::FormIDResolver& a_resolver);
+		void InitForms(const util::FormIDResolver& a_resolver);
+
+		// heap owned by the final lock data
+		[[nodiscard]] std::size_t GetHeapSize() const;
 
 		template <typename Func, typename... Args>
 		void ForEachModelType(Func&& func, Args&&... args)
@@ -111,12 +167,45 @@ namespace Lock
 		std::vector<Model> doors{};
 		std::vector<Model> lockpicks{};
 		Sound              sounds{};
+		std::uint32_t      config{};  // ini index of the first section
+		mutable Telemetry  telemetry{};
 	};
 
 	inline bool operator<(const Variant& a_lhs, const Type& a_rhs) { return a_lhs.type < a_rhs; }
 	inline bool operator<(const Type& a_lhs, const Variant& a_rhs) { return a_lhs < a_rhs.type; }
 	inline bool operator<(const Variant& a_lhs, const Variant& a_rhs) { return a_lhs.type < a_rhs.type; }
 
+	// collects sections in load order, then sorts and merges duplicate sections once
+	class VariantBuilder
+	{
+	public:
+		// a section copied into the load arena, with the sort key its Type would have
+		struct Entry
+		{
+			LID::Section     section;
+			std::pmr::string modelPath;    // sanitized
+			std::string_view locationStr;  // view into section.name
+			std::uint32_t    config;
+		};
+
+		VariantBuilder();
+
+		void Add(const LID::Section& a_section, std::uint32_t a_config);
+
+		[[nodiscard]] std::size_t                    Size() const { return entries.size(); }
+		[[nodiscard]] const std::pmr::vector<Entry>& GetSections() const { return entries; }
+
+		// heap allocates only the merged variants
+		[[nodiscard]] std::vector<Variant> Build();
+
+	private:
+		std::string_view Copy(std::string_view a_str);
+
+		// members
+		std::pmr::monotonic_buffer_resource text;     // section text, outlives the source file
+		std::pmr::vector<Entry>             entries;  // load arena
+	};
+
 	struct ConditionChecker
 	{
 		struct Texture
@@ -127,13 +216,34 @@ namespace Lock
 
 		ConditionChecker(RE::TESObjectREFR* a_ref, RE::TESBoundObject* a_base, RE::TESModel* a_model);
 
-		[[nodiscard]] std::tuple<bool, std::string, Sound> IsValid(const Variant& a_variant, bool a_isLockPick) const;
-		[[nodiscard]] const std::vector<Model>&            GetModels(const Variant& a_variant) const;
+		// first model that applies to this reference, once the variant type has matched
+		[[nodiscard]] const Model* GetMatch(const Variant& a_variant, ModelType a_type) const;
+		[[nodiscard]] ModelType    GetLockType() const;
 
 		// members
 		RE::TESBoundObject*  base{};
 		RE::BGSLocation*     location{};
 		std::string          modelPath{};
 		std::vector<Texture> textureSet{};
+		bool                 telemetry{ false };
+		mutable bool         dynamic{ false };  // an underwater condition was evaluated
+	};
+
+	// indices into the frozen variant table, so results stay valid (and serializable) for the session
+	struct Resolution
+	{
+		static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+		[[nodiscard]] bool HasLock() const { return lockVariant != npos; }
+		[[nodiscard]] bool HasLockpick() const { return lockpickVariant != npos; }
+
+		// members
+		RE::FormID    base{};
+		std::uint32_t lockVariant{ npos };
+		std::uint32_t lockModel{ npos };
+		std::uint32_t lockpickVariant{ npos };
+		std::uint32_t lockpickModel{ npos };
+		ModelType     lockType{ ModelType::kChest };
+		bool          dynamic{ false };  // depends on player state, never cached
 	};
 }
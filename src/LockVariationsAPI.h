@@ -0,0 +1,71 @@
+#pragma once
+
+// Query interface for other SKSE plugins.
+// Request it at or after kPostPostLoad by dispatching kRequestInterface to "Lock Variations":
+//
+//	LockVariationsAPI::InterfaceRequest request{ LockVariationsAPI::InterfaceVersion::kV1 };
+//	SKSE::GetMessagingInterface()->Dispatch(LockVariationsAPI::kRequestInterface, &request, sizeof(request), LockVariationsAPI::PluginName);
+//	auto api = static_cast<LockVariationsAPI::IVLockVariations1*>(request.api);
+//
+// Results are resolved without touching the active lockpicking session. The lock table is built in the background after
+// kDataLoaded; until it is ready every reference resolves to vanilla.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RE
+{
+	class TESObjectREFR;
+}
+
+namespace LockVariationsAPI
+{
+	inline constexpr auto PluginName = "Lock Variations";
+
+	enum : std::uint32_t
+	{
+		kRequestInterface = 'LVAR'
+	};
+
+	enum class InterfaceVersion : std::uint32_t
+	{
+		kV1 = 1
+	};
+
+	struct InterfaceRequest
+	{
+		InterfaceVersion interfaceVersion{ InterfaceVersion::kV1 };
+		void*            api{ nullptr };  // filled in by Lock Variations
+	};
+
+	// editorIDs of the sound descriptors played while lockpicking
+	struct SoundSet
+	{
+		const char* cylinderSqueakA;
+		const char* cylinderSqueakB;
+		const char* cylinderStop;
+		const char* cylinderTurn;
+		const char* pickMovement;
+		const char* lockpickingUnlock;
+	};
+
+	// strings are owned by Lock Variations and stay valid for the rest of the game session
+	struct LockResult
+	{
+		const char* lockModel;      // nullptr if the vanilla lock is used
+		const char* lockpickModel;  // nullptr if the vanilla lockpick is used
+		SoundSet    sounds;         // all nullptr if the vanilla sounds are used
+	};
+
+	class IVLockVariations1
+	{
+	public:
+		virtual ~IVLockVariations1() = default;
+
+		[[nodiscard]] virtual InterfaceVersion GetVersion() const = 0;
+
+		// resolves a_count references into a_results (same order, null references give vanilla results)
+		// returns how many references use at least one variant model
+		virtual std::size_t ResolveLocks(RE::TESObjectREFR* const* a_refs, std::size_t a_count, LockResult* a_results) = 0;
+	};
+}
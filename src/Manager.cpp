@@ -1,68 +1,415 @@
 #include "Manager.h"
+#include "Arena.h"
+#include "Profiler.h"
+#include "Settings.h"
+
+#ifdef EMBEDDED_CONFIGS
+#	include "EmbeddedConfigs.h"
+#endif
 
 bool Manager::LoadLocks()
 {
 	logger::info("{:*^30}", "INI");
 
-	std::vector<std::string> configs = dist::get_configs(R"(Data\)", "_LID"sv);
+	Profiler::Recorder::GetSingleton()->RecordMemory("before ini");
+	Profiler::Span loadSpan("LoadLocks", "ini");
 
-	if (configs.empty()) {
-		logger::warn("\tNo .ini files with _LID suffix were found within the Data folder, aborting...");
-		return false;
+	Arena::Begin();
+
+	Lock::VariantBuilder builder;
+
+#ifdef EMBEDDED_CONFIGS
+	LoadEmbeddedLocks(builder);
+	if (Settings::GetSingleton()->loadRuntimeConfigs) {
+		LoadRuntimeLocks(builder);
+	}
+#else
+	LoadRuntimeLocks(builder);
+#endif
+
+#ifndef NDEBUG
+	CompareBaselineBuild(builder);
+#endif
+
+	const auto numSections = builder.Size();
+	const auto start = std::chrono::steady_clock::now();
+
+	{
+		Profiler::Span span("MergeSections", "ini");
+		lockVariants = builder.Build();
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	logger::info("Merged {} sections into {} lock entries in {}us", numSections, lockVariants.size(), elapsed.count());
+
+	Profiler::Recorder::GetSingleton()->RecordMemory("after ini");
+
+	return !lockVariants.empty();
+}
+
+void Manager::LoadRuntimeLocks(Lock::VariantBuilder& a_builder)
+{
+	std::vector<std::string> paths;
+	{
+		Profiler::Span span("get_configs", "ini");
+		paths = dist::get_configs(R"(Data\)", "_LID"sv);
+	}
+
+	if (paths.empty()) {
+		logger::warn("\tNo .ini files with _LID suffix were found within the Data folder");
+		return;
 	}
 
-	logger::info("{} matching inis found", configs.size());
+	logger::info("{} matching inis found", paths.size());
 
-	std::ranges::sort(configs);
+	std::ranges::sort(paths);
 
-	for (auto& path : configs) {
+	for (auto& path : paths) {
+#ifdef EMBEDDED_CONFIGS
+		// curated lists usually ship the embedded files in Data too, don't add their sections twice
+		const auto filename = std::filesystem::path(path).filename().string();
+		if (std::ranges::any_of(Embedded::configs, [&](std::string_view a_config) { return string::iequals(a_config, filename); })) {
+			logger::info("INI : {} (skipped, already embedded)", path);
+			continue;
+		}
+#endif
 		logger::info("INI : {}", path);
 
-		Sanitize(path);
+		const auto index = static_cast<std::uint32_t>(configs.size());
+		configs.push_back(path);
 
-		CSimpleIniA ini;
-		ini.SetUnicode();
-		ini.SetMultiKey();
+		Profiler::Span fileSpan("File", "ini", path);
 
-		if (const auto rc = ini.LoadFile(path.c_str()); rc < 0) {
+		{
+			Profiler::Span span("Sanitize", "ini", path);
+			Sanitize(path);
+		}
+
+		LID::MappedFile file(path);
+		if (!file.IsOpen()) {
 			logger::error("\tcouldn't read INI");
 			continue;
 		}
 
-		CSimpleIniA::TNamesDepend sections;
-		ini.GetAllSections(sections);
-		sections.sort(CSimpleIniA::Entry::LoadOrder());
+		std::pmr::vector<LID::Section> sections(Arena::Get());
+		{
+			Profiler::Span span("LoadFile", "ini", path);
+			sections = LID::Parse(file.View(), Arena::Get());
+		}
+
+#ifndef NDEBUG
+		ValidateParse(path, sections);
+#endif
 
-		for (auto& [_section, comment, order] : sections) {
-			std::string section = _section;
-			if (auto it = lockVariants.find(section); it != lockVariants.end()) {
-				auto node = lockVariants.extract(it);
-				node.value().AddModels(ini, section);
-				lockVariants.insert(std::move(node));
-			} else {
-				lockVariants.emplace(ini, section);
+		{
+			Profiler::Span span("AddSections", "ini", path);
+
+			const auto detailed = Profiler::IsDetailed();
+			for (auto& section : sections) {
+				std::optional<Profiler::Span> sectionSpan;
+				if (detailed) {
+					sectionSpan.emplace("Section", "ini", fmt::format("{} [{}]", path, section.name));
+				}
+				a_builder.Add(section, index);
 			}
 		}
 	}
+}
 
-	return !lockVariants.empty();
+#ifdef EMBEDDED_CONFIGS
+void Manager::LoadEmbeddedLocks(Lock::VariantBuilder& a_builder)
+{
+	Profiler::Span span("Embedded", "ini");
+
+	const auto offset = static_cast<std::uint32_t>(configs.size());
+	for (const auto& config : Embedded::configs) {
+		logger::info("INI : {} (embedded)", config);
+		configs.emplace_back(config);
+	}
+
+	for (const auto& [config, name, firstKey, numKeys] : Embedded::sections) {
+		const auto keys = std::span(Embedded::keys).subspan(firstKey, numKeys);
+		a_builder.Add({ name, std::pmr::vector<LID::Key>(keys.begin(), keys.end(), Arena::Get()) }, offset + config);
+	}
+
+	logger::info("{} embedded sections", Embedded::sections.size());
 }
+#endif
 
-void Manager::InitLockForms()
+void Manager::InitLockFormsAsync()
 {
 	logger::info("{:*^30}", "DATA LOAD");
 
-	for (auto it = lockVariants.begin(); it != lockVariants.end(); it++) {
-		auto node = lockVariants.extract(it);
-		node.value().InitForms();
-		node.value().SortModels();
-		lockVariants.insert(std::move(node));
+	// form lookups only read the data handler, which is complete by kDataLoaded
+	initTask = std::async(std::launch::async, [this] {
+		Arena::SetOwner(std::this_thread::get_id());
+		InitLockForms();
+	}).share();
+
+	logger::info("Building lock entries in the background");
+}
+
+bool Manager::WaitUntilReady()
+{
+	if (!ready && initTask.valid()) {
+		initTask.wait();
+	}
+	return ready;
+}
+
+bool Manager::WaitUntilReady(std::chrono::milliseconds a_timeout)
+{
+	if (ready || !initTask.valid()) {
+		return ready;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto status = initTask.wait_for(a_timeout);
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+	if (status == std::future_status::ready) {
+		logger::warn("Lock entries were still building, waited {}us", elapsed.count());
+	} else {
+		logger::warn("Lock entries still building after {}ms, using vanilla models", a_timeout.count());
+	}
+	return ready;
+}
+
+void Manager::InitLockForms()
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	{
+		Profiler::Span initSpan("InitLockForms", "data");
+
+		util::FormIDResolver resolver;
+		{
+			Profiler::Span span("CollectForms", "data");
+			for (auto& variant : lockVariants) {
+				variant.CollectForms(resolver);
+			}
+		}
+		{
+			Profiler::Span span("ResolveForms", "data");
+			resolver.Resolve();
+		}
+
+		// neither step touches the sort key, so the flat set stays ordered
+		{
+			Profiler::Span span("InitForms", "data");
+
+			const auto detailed = Profiler::IsDetailed();
+			for (auto& variant : lockVariants) {
+				std::optional<Profiler::Span> variantSpan;
+				if (detailed) {
+					variantSpan.emplace("Variant", "data", variant.type.section);
+				}
+				variant.InitForms(resolver);
+				variant.SortModels();
+			}
+		}
+	}
+
+	PruneLockVariants();
+
+	ComputeFingerprint();
+
+	std::size_t retainedBytes = lockVariants.capacity() * sizeof(Lock::Variant);
+	for (auto& variant : lockVariants) {
+		retainedBytes += variant.GetHeapSize();
 	}
+	// no process memory sample here, this runs on a worker while the game keeps loading; the arena log measures our own load
+	Arena::Release(retainedBytes);
+
+	ready = true;
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	logger::info("Loaded {} lock entries in {}us", lockVariants.size(), elapsed.count());
+
+#ifndef NDEBUG
+	CompareBaselineScan();
+#endif
+
+	Profiler::Recorder::GetSingleton()->Export();
 
-	logger::info("Loaded {} lock entries", lockVariants.size());
 	logger::info("{:*^30}", "INFO");
 }
 
+// drops entries GetMatch/ResolveImpl can never return, before any resolution index is handed out
+void Manager::PruneLockVariants()
+{
+	Profiler::Span span("PruneVariants", "data");
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::size_t numModels = 0;
+	const auto  log_pruned = [&](const Lock::Variant& a_variant, const Lock::Model& a_model, std::string_view a_reason) {
+		logger::info("\tPruned [{}] {} = {} ({}) : {}", a_variant.type.section, a_model.key, a_model.model, configs[a_model.config], a_reason);
+		++numModels;
+	};
+
+	// earlier variants with an unconditional model, they claim that model type for every reference they match
+	std::array<std::vector<std::size_t>, 3> claims{};
+
+	for (std::size_t i = 0; i < lockVariants.size(); ++i) {
+		auto& variant = lockVariants[i];
+		for (const auto type : { Lock::ModelType::kChest, Lock::ModelType::kDoor, Lock::ModelType::kLockpick }) {
+			auto& models = variant.GetModels(type);
+			auto& claimed = claims[std::to_underlying(type)];
+
+			if (models.empty()) {
+				continue;
+			}
+
+			if (const auto it = std::ranges::find_if(claimed, [&](std::size_t a_index) { return lockVariants[a_index].type.Covers(variant.type); }); it != claimed.end()) {
+				const auto reason = fmt::format("shadowed by [{}]", lockVariants[*it].type.section);
+				for (auto& model : models) {
+					log_pruned(variant, model, reason);
+				}
+				models.clear();
+				continue;
+			}
+
+			const auto defaultModel = type == Lock::ModelType::kLockpick ? Lock::defaultLockPick : Lock::defaultLock;
+
+			std::optional<std::string> winner;
+			std::erase_if(models, [&](const Lock::Model& a_model) {
+				if (winner) {
+					log_pruned(variant, a_model, fmt::format("after unconditional {}", *winner));
+					return true;
+				}
+				if (a_model.model == defaultModel) {
+					log_pruned(variant, a_model, "default model");
+					return true;
+				}
+				if (a_model.condition && a_model.condition->IsNeverValid()) {
+					log_pruned(variant, a_model, "condition never matches");
+					return true;
+				}
+				if (!a_model.condition) {
+					winner = a_model.key;
+				}
+				return false;
+			});
+
+			if (winner) {
+				claimed.push_back(i);
+			}
+		}
+	}
+
+	const auto numVariants = std::erase_if(lockVariants, [](const Lock::Variant& a_variant) {
+		if (!a_variant.HasModels()) {
+			logger::info("\tPruned [{}] : no reachable models", a_variant.type.section);
+			return true;
+		}
+		return false;
+	});
+	lockVariants.shrink_to_fit();
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	logger::info("Pruned {} unreachable models and {} lock entries in {}us", numModels, numVariants, elapsed.count());
+}
+
+#ifndef NDEBUG
+// cross-check the _LID parser against CSimpleIni
+void Manager::ValidateParse(const std::string& a_path, const std::pmr::vector<LID::Section>& a_sections)
+{
+	Profiler::Span span("ValidateFile", "ini", a_path);
+
+	CSimpleIniA ini;
+	ini.SetUnicode();
+	ini.SetMultiKey();
+
+	if (const auto rc = ini.LoadFile(a_path.c_str()); rc < 0) {
+		logger::error("\tcouldn't read INI with CSimpleIni");
+		return;
+	}
+
+	const auto expected = LID::Parse(ini);
+	if (expected.size() != a_sections.size()) {
+		logger::error("\tparser mismatch : {} sections, CSimpleIni has {}", a_sections.size(), expected.size());
+		return;
+	}
+
+	for (std::size_t i = 0; i < expected.size(); ++i) {
+		if (expected[i] != a_sections[i]) {
+			logger::error("\tparser mismatch in [{}] : {} keys, CSimpleIni has [{}] with {} keys", a_sections[i].name, a_sections[i].keys.size(), expected[i].name, expected[i].keys.size());
+		}
+	}
+}
+
+void Manager::CompareBaselineBuild(const Lock::VariantBuilder& a_builder) const
+{
+	std::vector<Lock::Variant> sections;
+	sections.reserve(a_builder.GetSections().size());
+	for (auto& entry : a_builder.GetSections()) {
+		sections.emplace_back(entry.section, entry.config);
+	}
+
+	// the pre-flat-vector LoadLocks : find, extract, merge, reinsert per section
+	const auto start = std::chrono::steady_clock::now();
+
+	std::set<Lock::Variant, std::less<>> baseline;
+	for (auto& section : sections) {
+		if (const auto it = baseline.find(section.type); it != baseline.end()) {
+			auto node = baseline.extract(it);
+			node.value().MergeModels(std::move(section));
+			baseline.insert(std::move(node));
+		} else {
+			baseline.insert(std::move(section));
+		}
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	logger::info("\tbaseline : std::set built {} lock entries in {}us", baseline.size(), elapsed.count());
+}
+
+void Manager::CompareBaselineScan() const
+{
+	const std::set<Lock::Variant, std::less<>> baseline(lockVariants.begin(), lockVariants.end());
+
+	// no references exist yet, so probe with the configured model paths and walk every entry a lock with that model would
+	std::vector<std::string_view> probes;
+	for (auto& variant : lockVariants) {
+		if (probes.size() < 64 && !variant.type.modelPath.empty()) {
+			probes.push_back(variant.type.modelPath);
+		}
+	}
+	probes.push_back("lockvariationsprobe.nif"sv);
+
+	const auto scan = [&](const auto& a_variants) {
+		constexpr std::size_t numPasses = 100;
+
+		std::size_t touched = 0;
+		const auto  start = std::chrono::steady_clock::now();
+		for (std::size_t pass = 0; pass < numPasses; ++pass) {
+			for (const auto probe : probes) {
+				for (const auto& variant : a_variants) {
+					if (variant.type.modelPath.empty() || probe.contains(variant.type.modelPath)) {
+						for (const auto type : { Lock::ModelType::kChest, Lock::ModelType::kDoor, Lock::ModelType::kLockpick }) {
+							for (auto& model : variant.GetModels(type)) {
+								touched += model.condition.has_value();
+							}
+						}
+					}
+				}
+			}
+		}
+		const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		return std::make_pair(elapsed.count() / static_cast<std::int64_t>(numPasses * probes.size()), touched);
+	};
+
+	const auto [vectorNs, vectorTouched] = scan(lockVariants);
+	const auto [setNs, setTouched] = scan(baseline);
+
+	logger::info("\tbaseline : full scan over {} lock entries took {}ns (flat vector) vs {}ns (std::set), {} probes", lockVariants.size(), vectorNs, setNs, probes.size());
+	if (vectorTouched != setTouched) {
+		logger::error("\tbaseline : scans disagree ({} vs {} models)", vectorTouched, setTouched);
+	}
+}
+#endif
+
 // hack
 void Manager::Sanitize(const std::string& a_path)
 {
@@ -71,13 +418,21 @@ void Manager::Sanitize(const std::string& a_path)
 		return;
 	}
 
-	std::string             line;
-	std::deque<std::string> processedLines;
-	bool                    firstLine = true;
+	const auto arena = Arena::Get();
+
+	std::pmr::string                  line(arena);
+	std::pmr::deque<std::pmr::string> processedLines(arena);
+	bool                              firstLine = true;
 
-	bool                     underwater = false;
-	bool                     finishedUnderWater = false;
-	std::vector<std::string> underWaterLines;
+	bool                               underwater = false;
+	bool                               finishedUnderWater = false;
+	std::pmr::vector<std::pmr::string> underWaterLines(arena);
+
+	const auto replace_first_instance = [](std::pmr::string& a_str, std::string_view a_search, std::string_view a_replace) {
+		if (const auto pos = a_str.find(a_search); pos != std::pmr::string::npos) {
+			a_str.replace(pos, a_search.size(), a_replace);
+		}
+	};
 
 	constexpr unsigned char boms[]{ 0xef, 0xbb, 0xbf };
 	bool                    have_bom{ true };
@@ -98,15 +453,15 @@ void Manager::Sanitize(const std::string& a_path)
 			firstLine = false;
 		}
 		if (line.contains('[')) {
-			string::replace_first_instance(line, ":", "|");
+			replace_first_instance(line, ":", "|");
 		}
 		if (underwater) {
 			if (line.contains("Door")) {
-				string::replace_first_instance(line, "Door", "Door|NONE|underwater");
+				replace_first_instance(line, "Door", "Door|NONE|underwater");
 				underWaterLines.push_back(line);
 			}
 			if (line.contains("Chest")) {
-				string::replace_first_instance(line, "Chest", "Chest|NONE|underwater");
+				replace_first_instance(line, "Chest", "Chest|NONE|underwater");
 				underWaterLines.push_back(line);
 				finishedUnderWater = true;
 			}
@@ -123,33 +478,27 @@ void Manager::Sanitize(const std::string& a_path)
 	}
 
 	if (!underWaterLines.empty()) {
-		processedLines.push_front(underWaterLines[1] + "\n");
+		processedLines.push_front(underWaterLines[1]);
+		processedLines.front() += "\n";
 		processedLines.push_front(underWaterLines[0]);
 	}
 	processedLines.push_front(";4.0.0");
 
 	std::ofstream output(a_path);
-	std::ranges::copy(processedLines, std::ostream_iterator<std::string>(output, "\n"));
+	for (auto& processedLine : processedLines) {
+		output << processedLine << "\n";
+	}
 }
 
 std::string Manager::GetLockModel(const char* a_fallbackPath)
 {
 	//reset
-	currentSound = std::nullopt;
-
-	const auto ref = RE::LockpickingMenu::GetTargetReference();
-	const auto base = ref ? ref->GetBaseObject() : nullptr;
-	const auto model = base ? base->As<RE::TESModel>() : nullptr;
+	currentSound = nullptr;
 
-	if (ref && base && model) {
-		Lock::ConditionChecker checker(ref, base, model);
-		for (auto& variant : lockVariants) {
-			auto [result, modelPath, sounds] = checker.IsValid(variant, false);
-			if (result) {
-				currentSound = sounds;
-				return modelPath;
-			}
-		}
+	const auto resolution = ResolveOpening(RE::LockpickingMenu::GetTargetReference());
+	if (const auto modelPath = GetLockModel(resolution)) {
+		currentSound = GetSounds(resolution);
+		return *modelPath;
 	}
 
 	return a_fallbackPath;
@@ -159,28 +508,506 @@ std::string Manager::GetLockpickModel(const char* a_fallbackPath)
 {
 	std::string path(a_fallbackPath);
 
+	// counts as this opening's hook even for the skeleton key
+	const auto resolution = ResolveOpening(RE::LockpickingMenu::GetTargetReference());
 	if (path == Lock::skeletonKey) {
 		return path;
 	}
 
-	const auto ref = RE::LockpickingMenu::GetTargetReference();
-	const auto base = ref ? ref->GetBaseObject() : nullptr;
+	if (const auto modelPath = GetLockpickModel(resolution)) {
+		return *modelPath;
+	}
+
+	return path;
+}
+
+Lock::Resolution Manager::ResolveOpening(RE::TESObjectREFR* a_ref)
+{
+	// the second hook of the same opening reuses the first one's wait and result
+	const bool sameOpening = opening.hooksLeft > 0 && opening.ref == a_ref;
+	if (sameOpening) {
+		--opening.hooksLeft;
+	} else {
+		opening = { a_ref, 1 };
+	}
+
+	if (!opening.resolution && (sameOpening ? ready.load() : WaitUntilReady(initTimeout))) {
+		opening.resolution = Resolve(a_ref, std::chrono::microseconds(Settings::GetSingleton()->resolveBudget));
+	}
+
+	return opening.resolution.value_or(Lock::Resolution{});
+}
+
+const Lock::Sound* Manager::GetSounds()
+{
+	return currentSound;
+}
+
+Lock::Resolution Manager::Resolve(RE::TESObjectREFR* a_ref)
+{
+	return Resolve(a_ref, std::chrono::microseconds::zero());
+}
+
+Lock::Resolution Manager::Resolve(RE::TESObjectREFR* a_ref, std::chrono::microseconds a_budget)
+{
+	const auto base = a_ref ? a_ref->GetBaseObject() : nullptr;
 	const auto model = base ? base->As<RE::TESModel>() : nullptr;
 
-	if (ref && base && model) {
-		Lock::ConditionChecker checker(ref, base, model);
-		for (auto& variant : lockVariants) {
-			auto [result, modelPath, sounds] = checker.IsValid(variant, true);
-			if (result) {
-				return modelPath;
+	if (!a_ref || !base || !model || !ready) {
+		return {};
+	}
+
+	bool knownDynamic = false;
+	{
+		std::shared_lock locker(resolutionLock);
+		if (const auto it = resolutions.find(a_ref->GetFormID()); it != resolutions.end() && it->second.base == base->GetFormID()) {
+			return it->second;
+		}
+		if (const auto it = dynamicRefs.find(a_ref->GetFormID()); it != dynamicRefs.end() && it->second == base->GetFormID()) {
+			knownDynamic = true;
+		}
+	}
+
+	// the checker build counts against the budget, it sanitizes the model and texture paths
+	// (a dynamic result can't be cached, finishing it asynchronously would only repeat the overrun on every open)
+	std::optional<Budget> budget;
+	if (a_budget > std::chrono::microseconds::zero() && !knownDynamic) {
+		budget.emplace(std::chrono::steady_clock::now(), a_budget);
+	}
+
+	Lock::ConditionChecker checker(a_ref, base, model);
+	checker.telemetry = Settings::GetSingleton()->matchTelemetry;
+
+	auto resolution = ResolveImpl(checker, budget ? &*budget : nullptr);
+	resolution.base = base->GetFormID();
+
+	if (budget && budget->exceeded) {
+		LogOverBudget(*budget, a_ref);
+
+		if (resolution.dynamic) {
+			std::unique_lock locker(resolutionLock);
+			dynamicRefs.insert_or_assign(a_ref->GetFormID(), resolution.base);
+			return resolution;
+		}
+
+		PreResolveBatch batch;
+		batch.source = fmt::format("over budget {:X}", a_ref->GetFormID());
+		batch.refs.push_back({ a_ref->GetFormID(), std::move(checker) });
+		QueueBatch(std::move(batch));
+
+		return resolution;  // whatever matched before the deadline, vanilla for the rest
+	}
+
+	if (!resolution.dynamic) {
+		std::unique_lock locker(resolutionLock);
+		resolutions.insert_or_assign(a_ref->GetFormID(), resolution);
+	}
+
+	return resolution;
+}
+
+void Manager::RegisterPreResolve()
+{
+	if (!Settings::GetSingleton()->preResolveOnCellLoad) {
+		return;
+	}
+
+	RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink<RE::TESCellFullyLoadedEvent>(this);
+
+	logger::info("Registered for cell load events");
+}
+
+// main thread : gather the checker inputs, everything that touches the reference itself
+RE::BSEventNotifyControl Manager::ProcessEvent(const RE::TESCellFullyLoadedEvent* a_event, RE::BSTEventSource<RE::TESCellFullyLoadedEvent>*)
+{
+	const auto cell = a_event ? a_event->cell : nullptr;
+	if (!cell || !ready) {
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	PreResolveBatch batch;
+	batch.source = fmt::format("cell {} [{:X}]", edid::get_editorID(cell), cell->GetFormID());
+
+	struct Candidate
+	{
+		RE::TESObjectREFR*  ref;
+		RE::TESBoundObject* base;
+		RE::TESModel*       model;
+	};
+
+	std::vector<Candidate> candidates;
+	{
+		std::shared_lock locker(resolutionLock);
+		cell->ForEachReference([&](RE::TESObjectREFR* a_ref) {
+			const auto base = a_ref ? a_ref->GetBaseObject() : nullptr;
+			const auto model = base ? base->As<RE::TESModel>() : nullptr;
+			if (model && a_ref->IsLocked()) {
+				const auto cached = resolutions.find(a_ref->GetFormID());
+				const auto dynamic = dynamicRefs.find(a_ref->GetFormID());
+				// dynamic results can't be cached, pre-resolving them on every cell load would be wasted
+				if ((cached == resolutions.end() || cached->second.base != base->GetFormID()) &&
+					(dynamic == dynamicRefs.end() || dynamic->second != base->GetFormID())) {
+					candidates.push_back({ a_ref, base, model });
+				}
+			}
+			return RE::BSContainer::ForEachResult::kContinue;
+		});
+	}
+
+	// checkers evaluate regexes, keep that out of the lock the worker needs to publish results
+	batch.refs.reserve(candidates.size());
+	for (const auto& [ref, base, model] : candidates) {
+		batch.refs.push_back({ ref->GetFormID(), Lock::ConditionChecker(ref, base, model) });
+	}
+
+	if (batch.refs.empty()) {
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+	batch.collectTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+	QueueBatch(std::move(batch));
+
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+void Manager::QueueBatch(PreResolveBatch&& a_batch)
+{
+	std::call_once(batchWorkerStarted, [this] {
+		batchWorker = std::jthread([this](std::stop_token a_stop) { PreResolveLoop(a_stop); });
+	});
+
+	{
+		std::scoped_lock locker(batchLock);
+		batches.push_back(std::move(a_batch));
+	}
+	batchReady.notify_one();
+}
+
+void Manager::PreResolveLoop(std::stop_token a_stop)
+{
+	while (true) {
+		std::vector<PreResolveBatch> pending;
+		{
+			std::unique_lock locker(batchLock);
+			if (!batchReady.wait(locker, a_stop, [&] { return !batches.empty(); })) {
+				return;
 			}
+			pending.swap(batches);
+		}
+		for (auto& batch : pending) {
+			PreResolve(batch);
 		}
 	}
+}
 
-	return path;
+// worker thread : lockVariants is frozen, so only the cache needs locking
+void Manager::PreResolve(PreResolveBatch& a_batch)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const auto telemetry = Settings::GetSingleton()->matchTelemetry;
+
+	std::vector<std::pair<RE::FormID, Lock::Resolution>> results;
+	results.reserve(a_batch.refs.size());
+
+	std::size_t numDynamic = 0;
+	for (auto& [formID, checker] : a_batch.refs) {
+		checker.telemetry = telemetry;
+
+		auto resolution = ResolveImpl(checker);
+		resolution.base = checker.base->GetFormID();
+
+		if (resolution.dynamic) {
+			++numDynamic;
+		}
+		results.emplace_back(formID, resolution);
+	}
+
+	{
+		std::unique_lock locker(resolutionLock);
+		for (auto& [formID, resolution] : results) {
+			if (resolution.dynamic) {
+				dynamicRefs.insert_or_assign(formID, resolution.base);
+			} else {
+				resolutions.insert_or_assign(formID, resolution);
+			}
+		}
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	logger::info("Pre-resolved {} locked references ({}, {} dynamic, left to resolve on open) : {}us on worker, {}us collecting on main thread", a_batch.refs.size(), a_batch.source, numDynamic, elapsed.count(), a_batch.collectTime.count());
 }
 
-const std::optional<Lock::Sound>& Manager::GetSounds()
+void Manager::ClearResolutions()
 {
-	return currentSound;
+	std::unique_lock locker(resolutionLock);
+	resolutions.clear();
+	dynamicRefs.clear();
+}
+
+std::uint64_t Manager::GetFingerprint() const
+{
+	return fingerprint;
+}
+
+std::vector<std::pair<RE::FormID, Lock::Resolution>> Manager::GetResolutions()
+{
+	std::shared_lock locker(resolutionLock);
+	return { resolutions.begin(), resolutions.end() };
+}
+
+bool Manager::AddResolution(RE::FormID a_formID, const Lock::Resolution& a_resolution)
+{
+	if (!ready || a_resolution.dynamic || !IsValid(a_resolution)) {
+		return false;
+	}
+
+	std::unique_lock locker(resolutionLock);
+	resolutions.insert_or_assign(a_formID, a_resolution);
+	return true;
+}
+
+bool Manager::IsValid(const Lock::Resolution& a_resolution) const
+{
+	if (a_resolution.lockType > Lock::ModelType::kDoor) {
+		return false;
+	}
+	if (a_resolution.HasLock() && (a_resolution.lockVariant >= lockVariants.size() || a_resolution.lockModel >= lockVariants[a_resolution.lockVariant].GetModels(a_resolution.lockType).size())) {
+		return false;
+	}
+	if (a_resolution.HasLockpick() && (a_resolution.lockpickVariant >= lockVariants.size() || a_resolution.lockpickModel >= lockVariants[a_resolution.lockpickVariant].lockpicks.size())) {
+		return false;
+	}
+	return true;
+}
+
+// FNV-1a over everything a resolution index depends on
+void Manager::ComputeFingerprint()
+{
+	fingerprint = 0xcbf29ce484222325;
+
+	const auto hash = [&](const void* a_data, std::size_t a_size) {
+		for (const auto byte : std::span(static_cast<const std::uint8_t*>(a_data), a_size)) {
+			fingerprint = (fingerprint ^ byte) * 0x100000001b3;
+		}
+	};
+	const auto hash_str = [&](std::string_view a_str) {
+		hash(a_str.data(), a_str.size());
+		hash("\0", 1);
+	};
+	const auto hash_num = [&](auto a_num) {
+		hash(&a_num, sizeof(a_num));
+	};
+
+	if (const auto dataHandler = RE::TESDataHandler::GetSingleton()) {
+		for (const auto file : dataHandler->files) {
+			hash_str(file ? file->GetFilename() : ""sv);
+		}
+	}
+
+	hash_num(lockVariants.size());
+	for (auto& variant : lockVariants) {
+		hash_str(variant.type.section);
+		hash_num(variant.type.locationID);
+		for (const auto type : { Lock::ModelType::kChest, Lock::ModelType::kDoor, Lock::ModelType::kLockpick }) {
+			const auto& models = variant.GetModels(type);
+			hash_num(models.size());
+			for (auto& model : models) {
+				hash_str(model.key);
+				hash_str(model.model);
+				if (model.condition) {
+					hash_num(model.condition->flags);
+					for (auto& id : model.condition->ids) {
+						std::visit(overload{
+									   [&](RE::FormID a_formID) { hash_num(a_formID); },
+									   [&](const std::string& a_path) { hash_str(a_path); } },
+							id);
+					}
+				}
+			}
+		}
+	}
+}
+
+const std::string* Manager::GetLockModel(const Lock::Resolution& a_resolution) const
+{
+	if (!a_resolution.HasLock()) {
+		return nullptr;
+	}
+	return &lockVariants[a_resolution.lockVariant].GetModels(a_resolution.lockType)[a_resolution.lockModel].model;
+}
+
+const std::string* Manager::GetLockpickModel(const Lock::Resolution& a_resolution) const
+{
+	if (!a_resolution.HasLockpick()) {
+		return nullptr;
+	}
+	return &lockVariants[a_resolution.lockpickVariant].lockpicks[a_resolution.lockpickModel].model;
+}
+
+const Lock::Sound* Manager::GetSounds(const Lock::Resolution& a_resolution) const
+{
+	return a_resolution.HasLock() ? &lockVariants[a_resolution.lockVariant].sounds : nullptr;
+}
+
+Lock::Resolution Manager::ResolveImpl(const Lock::ConditionChecker& a_checker, Budget* a_budget) const
+{
+	Lock::Resolution resolution;
+	resolution.lockType = a_checker.GetLockType();
+
+	auto lastCheck = a_budget ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	if (a_budget && lastCheck - a_budget->start > a_budget->limit) {
+		a_budget->exceeded = true;
+		return resolution;
+	}
+
+	for (std::uint32_t i = 0; i < lockVariants.size(); ++i) {
+		const auto& variant = lockVariants[i];
+		if (a_checker.telemetry) {
+			Lock::Telemetry::Increment(variant.telemetry.evaluated);
+		}
+		if (!variant.type.IsValid(a_checker)) {
+			if (a_checker.telemetry) {
+				Lock::Telemetry::Increment(variant.telemetry.rejectedByType);
+			}
+			continue;
+		}
+		const auto matched = [&]() {
+			return resolution.lockVariant == i || resolution.lockpickVariant == i;
+		};
+		// whether a model list was actually searched, a variant is only rejected by condition if one was
+		bool tried = false;
+		if (!resolution.HasLock()) {
+			tried |= !variant.GetModels(resolution.lockType).empty();
+			if (const auto model = a_checker.GetMatch(variant, resolution.lockType)) {
+				resolution.lockVariant = i;
+				resolution.lockModel = static_cast<std::uint32_t>(model - variant.GetModels(resolution.lockType).data());
+			}
+		}
+		if (!resolution.HasLockpick()) {
+			tried |= !variant.lockpicks.empty();
+			if (const auto model = a_checker.GetMatch(variant, Lock::ModelType::kLockpick)) {
+				resolution.lockpickVariant = i;
+				resolution.lockpickModel = static_cast<std::uint32_t>(model - variant.lockpicks.data());
+			}
+		}
+		if (a_checker.telemetry) {
+			if (matched()) {
+				Lock::Telemetry::Increment(variant.telemetry.matched);
+			} else {
+				Lock::Telemetry::Increment(tried ? variant.telemetry.rejectedByCondition : variant.telemetry.notTried);
+			}
+		}
+		if (resolution.HasLock() && resolution.HasLockpick()) {
+			break;
+		}
+		if (a_budget) {
+			const auto now = std::chrono::steady_clock::now();
+			if (now - lastCheck > a_budget->slowest) {
+				a_budget->slowest = std::chrono::duration_cast<std::chrono::microseconds>(now - lastCheck);
+				a_budget->slowestVariant = i;
+			}
+			lastCheck = now;
+			// past the last entry the result is complete, however long it took
+			if (i + 1 < lockVariants.size() && now - a_budget->start > a_budget->limit) {
+				a_budget->exceeded = true;
+				a_budget->evaluated = i + 1;
+				break;
+			}
+		}
+	}
+
+	resolution.dynamic = a_checker.dynamic;
+
+	return resolution;
+}
+
+void Manager::LogOverBudget(const Budget& a_budget, const RE::TESObjectREFR* a_ref)
+{
+	const auto count = ++overBudgetCount;
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - a_budget.start);
+
+	if (a_budget.slowestVariant < lockVariants.size()) {
+		const auto& variant = lockVariants[a_budget.slowestVariant];
+		logger::warn("Resolve over budget ({}us > {}us, #{} this session) for {:X} after {}/{} lock entries : slowest [{}] ({}us, {}), finishing asynchronously",
+			elapsed.count(), a_budget.limit.count(), count, a_ref->GetFormID(), a_budget.evaluated, lockVariants.size(),
+			variant.type.section, a_budget.slowest.count(), configs[variant.config]);
+	} else {
+		logger::warn("Resolve over budget ({}us > {}us, #{} this session) for {:X} before any lock entry was evaluated, finishing asynchronously",
+			elapsed.count(), a_budget.limit.count(), count, a_ref->GetFormID());
+	}
+}
+
+void Manager::DumpTelemetry() const
+{
+	if (!Settings::GetSingleton()->matchTelemetry || !ready) {
+		return;
+	}
+
+	auto path = logger::log_directory();
+	if (!path) {
+		return;
+	}
+	*path /= fmt::format("{}_matches.csv", Version::PROJECT);
+
+	struct Row
+	{
+		std::uint32_t    config;
+		std::string_view section;
+		std::string_view entry;
+		Lock::Telemetry* telemetry;
+		bool             model;
+	};
+
+	std::vector<Row> rows;
+	for (auto& variant : lockVariants) {
+		rows.push_back({ variant.config, variant.type.section, {}, &variant.telemetry, false });
+		for (const auto type : { Lock::ModelType::kChest, Lock::ModelType::kDoor, Lock::ModelType::kLockpick }) {
+			for (auto& model : variant.GetModels(type)) {
+				rows.push_back({ model.config, variant.type.section, model.key, &model.telemetry, true });
+			}
+		}
+	}
+
+	std::ranges::stable_sort(rows, [](const Row& a_lhs, const Row& a_rhs) {
+		return a_lhs.config != a_rhs.config ? a_lhs.config < a_rhs.config : a_lhs.section < a_rhs.section;
+	});
+
+	const auto quote = [](std::string_view a_str) {
+		std::string result{ '"' };
+		for (const auto c : a_str) {
+			if (c == '"') {
+				result += '"';
+			}
+			result += c;
+		}
+		return result += '"';
+	};
+
+	// rejected_by_type and not_tried only apply to lock entries, models leave them empty
+	std::ofstream output(*path);
+	output << "file,section,entry,evaluated,rejected_by_type,rejected_by_condition,not_tried,matched\n";
+
+	// the worker thread may still be resolving
+	using Lock::Telemetry;
+	std::size_t numUnmatched = 0;
+	for (auto& [config, section, entry, telemetry, isModel] : rows) {
+		const auto matched = Telemetry::Load(telemetry->matched);
+		output << fmt::format("{},{},{},{},{},{},{},{}\n",
+			quote(configs[config]),
+			quote(section),
+			quote(entry),
+			Telemetry::Load(telemetry->evaluated),
+			isModel ? std::string() : std::to_string(Telemetry::Load(telemetry->rejectedByType)),
+			Telemetry::Load(telemetry->rejectedByCondition),
+			isModel ? std::string() : std::to_string(Telemetry::Load(telemetry->notTried)),
+			matched);
+		if (matched == 0) {
+			++numUnmatched;
+		}
+	}
+
+	logger::info("Wrote match telemetry for {} entries ({} never matched) to {}", rows.size(), numUnmatched, path->string());
 }
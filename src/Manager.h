@@ -2,21 +2,124 @@
 
 #include "LockData.h"
 
-class Manager : public ISingleton<Manager>
+class Manager :
+	public ISingleton<Manager>,
+	public RE::BSTEventSink<RE::TESCellFullyLoadedEvent>
 {
 public:
 	bool LoadLocks();
-	void InitLockForms();
+	void InitLockFormsAsync();
+
+	// blocks until the lock table is published, or the timeout runs out
+	bool WaitUntilReady();
+	bool WaitUntilReady(std::chrono::milliseconds a_timeout);
 
 	std::string GetLockModel(const char* a_fallbackPath);
 	std::string GetLockpickModel(const char* a_fallbackPath);
 
-	const std::optional<Lock::Sound>& GetSounds();
+	const Lock::Sound* GetSounds();
+
+	// no side effects on the current lockpicking session; safe to call from other plugins
+	Lock::Resolution Resolve(RE::TESObjectREFR* a_ref);
+	void             ClearResolutions();
+
+	// co-save support, resolutions are only valid for the config set matching the fingerprint
+	std::uint64_t                                         GetFingerprint() const;
+	std::vector<std::pair<RE::FormID, Lock::Resolution>> GetResolutions();
+	bool                                                  AddResolution(RE::FormID a_formID, const Lock::Resolution& a_resolution);
+
+	const std::string* GetLockModel(const Lock::Resolution& a_resolution) const;
+	const std::string* GetLockpickModel(const Lock::Resolution& a_resolution) const;
+	const Lock::Sound* GetSounds(const Lock::Resolution& a_resolution) const;
+
+	// bPreResolveOnCellLoad: locked references are resolved off the main thread as their cell loads
+	void RegisterPreResolve();
+
+	// writes per-entry match counters (bMatchTelemetry) to a csv next to the log
+	void DumpTelemetry() const;
 
 private:
+	struct PreResolveBatch
+	{
+		struct Entry
+		{
+			RE::FormID             formID;
+			Lock::ConditionChecker checker;
+		};
+
+		// members
+		std::string               source{};
+		std::vector<Entry>        refs{};
+		std::chrono::microseconds collectTime{};
+	};
+
+	// per-call deadline for the hooks (iResolveBudgetUs)
+	struct Budget
+	{
+		std::chrono::steady_clock::time_point start;
+		std::chrono::microseconds             limit;
+		std::chrono::microseconds             slowest{};
+		std::uint32_t                         slowestVariant{ Lock::Resolution::npos };
+		std::uint32_t                         evaluated{};
+		bool                                  exceeded{ false };
+	};
+
+	// both model hooks of one lockpicking menu open, in either order
+	struct Opening
+	{
+		RE::TESObjectREFR*              ref{};
+		std::uint32_t                   hooksLeft{};
+		std::optional<Lock::Resolution> resolution{};
+	};
+
+	Lock::Resolution ResolveOpening(RE::TESObjectREFR* a_ref);
+
+	Lock::Resolution Resolve(RE::TESObjectREFR* a_ref, std::chrono::microseconds a_budget);
+	void             LogOverBudget(const Budget& a_budget, const RE::TESObjectREFR* a_ref);
+
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESCellFullyLoadedEvent* a_event, RE::BSTEventSource<RE::TESCellFullyLoadedEvent>*) override;
+
+	void QueueBatch(PreResolveBatch&& a_batch);
+	void PreResolveLoop(std::stop_token a_stop);
+	void PreResolve(PreResolveBatch& a_batch);
+
+	void InitLockForms();
+	void PruneLockVariants();
+	void LoadRuntimeLocks(Lock::VariantBuilder& a_builder);
+#ifdef EMBEDDED_CONFIGS
+	void LoadEmbeddedLocks(Lock::VariantBuilder& a_builder);
+#endif
 	void Sanitize(const std::string& a_path);
-	
+#ifndef NDEBUG
+	void ValidateParse(const std::string& a_path, const std::pmr::vector<LID::Section>& a_sections);
+
+	// one-off timings of the flat vector against the std::set it replaced
+	void CompareBaselineBuild(const Lock::VariantBuilder& a_builder) const;
+	void CompareBaselineScan() const;
+#endif
+
+	Lock::Resolution ResolveImpl(const Lock::ConditionChecker& a_checker, Budget* a_budget = nullptr) const;
+	bool             IsValid(const Lock::Resolution& a_resolution) const;
+	void             ComputeFingerprint();
+
+	// how long a lock opened during the background build may stall the frame
+	static constexpr std::chrono::milliseconds initTimeout{ 50 };
+
 	// members
-	std::set<Lock::Variant, std::less<>> lockVariants{};
-	std::optional<Lock::Sound>           currentSound{};
+	std::vector<std::string>                         configs{};
+	std::vector<Lock::Variant>                       lockVariants{};  // sorted flat set, frozen after kDataLoaded
+	std::atomic_bool                                 ready{ false };  // set once the worker has published lockVariants
+	std::shared_future<void>                         initTask{};
+	std::uint64_t                                    fingerprint{};
+	std::shared_mutex                                resolutionLock{};
+	std::unordered_map<RE::FormID, Lock::Resolution> resolutions{};
+	std::unordered_map<RE::FormID, RE::FormID>       dynamicRefs{};  // ref -> base, never cached so resolved in full on open
+	const Lock::Sound*                               currentSound{};
+	Opening                                          opening{};  // main thread only
+	std::atomic_uint32_t                             overBudgetCount{};
+	std::once_flag                                   batchWorkerStarted{};
+	std::mutex                                       batchLock{};
+	std::condition_variable_any                      batchReady{};
+	std::vector<PreResolveBatch>                     batches{};
+	std::jthread                                     batchWorker{};  // last, joins before the queue is destroyed
 };
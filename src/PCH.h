@@ -3,7 +3,15 @@
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <future>
+#include <memory_resource>
+#include <mutex>
 #include <ranges>
+#include <shared_mutex>
+#include <thread>
 
 #include "RE/Skyrim.h"
 #include "SKSE/SKSE.h"
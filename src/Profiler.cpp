@@ -0,0 +1,191 @@
+#include "Profiler.h"
+#include "Settings.h"
+
+#include <Windows.h>
+
+#include <Psapi.h>
+
+namespace Profiler
+{
+	namespace detail
+	{
+		std::string escape(std::string_view a_str)
+		{
+			std::string result;
+			result.reserve(a_str.size());
+			for (const auto c : a_str) {
+				switch (c) {
+				case '"':
+					result += R"(\")";
+					break;
+				case '\\':
+					result += R"(\\)";
+					break;
+				case '\n':
+					result += R"(\n)";
+					break;
+				case '\r':
+					result += R"(\r)";
+					break;
+				case '\t':
+					result += R"(\t)";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						result += fmt::format(R"(\u{:04x})", static_cast<unsigned char>(c));
+					} else {
+						result += c;
+					}
+					break;
+				}
+			}
+			return result;
+		}
+
+		std::int64_t to_us(clock::duration a_duration)
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(a_duration).count();
+		}
+
+		double to_mb(std::size_t a_bytes)
+		{
+			return static_cast<double>(a_bytes) / (1024.0 * 1024.0);
+		}
+	}
+
+	bool IsDetailed()
+	{
+		return Settings::GetSingleton()->profileStartup;
+	}
+
+	void Recorder::Record(Event&& a_event)
+	{
+		std::scoped_lock locker(lock);
+		a_event.thread = threads.try_emplace(std::this_thread::get_id(), static_cast<std::uint32_t>(threads.size())).first->second;
+		events.push_back(std::move(a_event));
+	}
+
+	void Recorder::RecordMemory(std::string_view a_label)
+	{
+		PROCESS_MEMORY_COUNTERS_EX counters{};
+		if (!::GetProcessMemoryInfo(::GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+			return;
+		}
+
+		std::scoped_lock locker(lock);
+		memorySamples.push_back({ std::string(a_label), clock::now(), counters.WorkingSetSize, counters.PrivateUsage });
+	}
+
+	void Recorder::Export()
+	{
+		std::scoped_lock locker(lock);
+
+		if (events.empty()) {
+			return;
+		}
+
+		if (auto path = logger::log_directory(); path && IsDetailed()) {
+			*path /= fmt::format("{}_trace.json", Version::PROJECT);
+
+			std::ofstream output(*path);
+			output << R"({"displayTimeUnit":"ms","traceEvents":[)";
+			bool first = true;
+			for (auto& event : events) {
+				output << (first ? "\n" : ",\n");
+				output << fmt::format(R"({{"name":"{}","cat":"{}","ph":"X","pid":1,"tid":{},"ts":{},"dur":{},"args":{{"detail":"{}"}}}})",
+					detail::escape(event.name),
+					detail::escape(event.category),
+					event.thread,
+					detail::to_us(event.start - epoch),
+					detail::to_us(event.duration),
+					detail::escape(event.detail));
+				first = false;
+			}
+			for (auto& sample : memorySamples) {
+				output << fmt::format(R"(,
+{{"name":"memory","ph":"C","pid":1,"ts":{},"args":{{"workingSetMB":{:.2f},"privateMB":{:.2f}}}}})",
+					detail::to_us(sample.time - epoch),
+					detail::to_mb(sample.workingSet),
+					detail::to_mb(sample.privateBytes));
+			}
+			output << "\n]}\n";
+
+			logger::info("Wrote startup trace to {}", path->string());
+		}
+
+		struct Summary
+		{
+			std::string_view category;
+			std::string_view name;
+			std::size_t      count{};
+			clock::duration  total{};
+			const Event*     slowest{};
+		};
+
+		std::vector<Summary> summaries;
+		for (auto& event : events) {
+			auto it = std::ranges::find_if(summaries, [&](const auto& summary) {
+				return summary.name == event.name && summary.category == event.category;
+			});
+			if (it == summaries.end()) {
+				it = summaries.insert(summaries.end(), Summary{ event.category, event.name });
+			}
+			it->count++;
+			it->total += event.duration;
+			if (!it->slowest || it->slowest->duration < event.duration) {
+				it->slowest = &event;
+			}
+		}
+
+		std::ranges::sort(summaries, [](const auto& a_lhs, const auto& a_rhs) {
+			return a_lhs.total > a_rhs.total;
+		});
+
+		logger::info("{:*^30}", "PROFILE");
+		logger::info("{:<10} {:<16} {:>7} {:>12} {:>12}  {}", "category", "span", "count", "total(us)", "max(us)", "slowest");
+		for (auto& summary : summaries) {
+			logger::info("{:<10} {:<16} {:>7} {:>12} {:>12}  {}",
+				summary.category,
+				summary.name,
+				summary.count,
+				detail::to_us(summary.total),
+				detail::to_us(summary.slowest->duration),
+				summary.slowest->detail);
+		}
+
+		// the game dominates the absolute numbers, only the growth across one of our phases says anything about the configs
+		for (auto& sample : memorySamples) {
+			const auto before = sample.label.starts_with("after ") ?
+			                        std::ranges::find(memorySamples, "before " + sample.label.substr(6), &MemorySample::label) :
+			                        memorySamples.end();
+			if (before != memorySamples.end()) {
+				logger::info("memory     {:<16} working set {:.2f}MB, private {:.2f}MB, private delta {:+.2f}MB",
+					sample.label,
+					detail::to_mb(sample.workingSet),
+					detail::to_mb(sample.privateBytes),
+					(static_cast<double>(sample.privateBytes) - static_cast<double>(before->privateBytes)) / (1024.0 * 1024.0));
+			} else {
+				logger::info("memory     {:<16} working set {:.2f}MB, private {:.2f}MB",
+					sample.label,
+					detail::to_mb(sample.workingSet),
+					detail::to_mb(sample.privateBytes));
+			}
+		}
+
+		events.clear();
+		memorySamples.clear();
+	}
+
+	Span::Span(std::string_view a_name, std::string_view a_category, std::string_view a_detail) :
+		name(a_name),
+		category(a_category),
+		detail(a_detail),
+		start(clock::now())
+	{}
+
+	Span::~Span()
+	{
+		const auto end = clock::now();
+		Recorder::GetSingleton()->Record({ std::string(name), std::string(category), std::move(detail), 0, start, end - start });
+	}
+}
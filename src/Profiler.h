@@ -0,0 +1,66 @@
+#pragma once
+
+// startup timing spans, exported as a Chrome trace (chrome://tracing, Perfetto)
+namespace Profiler
+{
+	using clock = std::chrono::steady_clock;
+
+	// [Debug] bProfileStartup : per-section/per-variant spans and the trace file, phases and files are always timed
+	[[nodiscard]] bool IsDetailed();
+
+	struct Event
+	{
+		std::string       name{};
+		std::string       category{};
+		std::string       detail{};
+		std::uint32_t     thread{};  // assigned on record
+		clock::time_point start{};
+		clock::duration   duration{};
+	};
+
+	struct MemorySample
+	{
+		std::string       label{};
+		clock::time_point time{};
+		std::size_t       workingSet{};
+		std::size_t       privateBytes{};
+	};
+
+	class Recorder : public ISingleton<Recorder>
+	{
+	public:
+		void Record(Event&& a_event);
+		// "after <phase>" samples are logged with the private bytes delta since "before <phase>"
+		void RecordMemory(std::string_view a_label);
+
+		// writes a summary table to the log, and the trace next to it when detailed
+		void Export();
+
+	private:
+		// members
+		std::mutex                                         lock{};
+		clock::time_point                                  epoch{ clock::now() };
+		std::vector<Event>                                 events{};
+		std::vector<MemorySample>                          memorySamples{};
+		std::unordered_map<std::thread::id, std::uint32_t> threads{};
+	};
+
+	class Span
+	{
+	public:
+		Span(std::string_view a_name, std::string_view a_category, std::string_view a_detail = {});
+		~Span();
+
+		Span(const Span&) = delete;
+		Span(Span&&) = delete;
+		Span& operator=(const Span&) = delete;
+		Span& operator=(Span&&) = delete;
+
+	private:
+		// members
+		std::string_view  name;
+		std::string_view  category;
+		std::string       detail;
+		clock::time_point start;
+	};
+}
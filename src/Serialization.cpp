@@ -0,0 +1,129 @@
+#include "Serialization.h"
+#include "Manager.h"
+#include "Settings.h"
+
+namespace Serialization
+{
+	// bytes per stored entry, as written by SaveCallback
+	inline constexpr std::size_t kResolutionSize =
+		sizeof(RE::FormID) + sizeof(Lock::Resolution::base) +
+		sizeof(Lock::Resolution::lockVariant) + sizeof(Lock::Resolution::lockModel) +
+		sizeof(Lock::Resolution::lockpickVariant) + sizeof(Lock::Resolution::lockpickModel) +
+		sizeof(Lock::Resolution::lockType);
+
+	void Register()
+	{
+		const auto serialization = SKSE::GetSerializationInterface();
+		serialization->SetUniqueID(kUniqueID);
+		serialization->SetSaveCallback(SaveCallback);
+		serialization->SetLoadCallback(LoadCallback);
+		serialization->SetRevertCallback(RevertCallback);
+	}
+
+	void SaveCallback(SKSE::SerializationInterface* a_intfc)
+	{
+		if (!Settings::GetSingleton()->persistResolutions) {
+			return;
+		}
+
+		const auto manager = Manager::GetSingleton();
+		const auto resolutions = manager->GetResolutions();
+
+		if (!a_intfc->OpenRecord(kResolutions, kSerializationVersion)) {
+			logger::error("Failed to open resolution record");
+			return;
+		}
+
+		a_intfc->WriteRecordData(manager->GetFingerprint());
+		a_intfc->WriteRecordData(static_cast<std::uint32_t>(resolutions.size()));
+
+		for (auto& [formID, resolution] : resolutions) {
+			a_intfc->WriteRecordData(formID);
+			a_intfc->WriteRecordData(resolution.base);
+			a_intfc->WriteRecordData(resolution.lockVariant);
+			a_intfc->WriteRecordData(resolution.lockModel);
+			a_intfc->WriteRecordData(resolution.lockpickVariant);
+			a_intfc->WriteRecordData(resolution.lockpickModel);
+			a_intfc->WriteRecordData(resolution.lockType);
+		}
+	}
+
+	void LoadCallback(SKSE::SerializationInterface* a_intfc)
+	{
+		const auto manager = Manager::GetSingleton();
+		const auto persist = Settings::GetSingleton()->persistResolutions;
+
+		// the fingerprint only exists once the lock table is built
+		if (persist && !manager->WaitUntilReady()) {
+			logger::warn("Discarding stored resolutions : lock entries failed to build");
+			return;
+		}
+
+		std::uint32_t type;
+		std::uint32_t version;
+		std::uint32_t length;
+		while (a_intfc->GetNextRecordInfo(type, version, length)) {
+			if (type != kResolutions || !persist) {
+				continue;
+			}
+			if (version != kSerializationVersion) {
+				logger::warn("Discarding stored resolutions : record version {} (expected {})", version, kSerializationVersion);
+				continue;
+			}
+
+			const auto read = [&](auto& a_value) {
+				return a_intfc->ReadRecordData(a_value) == sizeof(a_value);
+			};
+
+			std::uint64_t fingerprint{};
+			if (!read(fingerprint)) {
+				logger::warn("Discarding stored resolutions : record truncated ({} bytes)", length);
+				continue;
+			}
+			if (fingerprint != manager->GetFingerprint()) {
+				logger::info("Discarding stored resolutions : configs or load order changed");
+				continue;
+			}
+
+			std::uint32_t count{};
+			if (!read(count)) {
+				logger::warn("Discarding stored resolutions : record truncated ({} bytes)", length);
+				continue;
+			}
+
+			constexpr std::size_t headerSize = sizeof(fingerprint) + sizeof(count);
+			if (static_cast<std::uint64_t>(count) * kResolutionSize > length - headerSize) {
+				logger::warn("Discarding stored resolutions : {} entries don't fit in a {} byte record", count, length);
+				continue;
+			}
+
+			std::uint32_t numLoaded = 0;
+			for (std::uint32_t i = 0; i < count; ++i) {
+				RE::FormID       formID{};
+				Lock::Resolution resolution{};
+
+				if (!read(formID) || !read(resolution.base) ||
+					!read(resolution.lockVariant) || !read(resolution.lockModel) ||
+					!read(resolution.lockpickVariant) || !read(resolution.lockpickModel) ||
+					!read(resolution.lockType)) {
+					logger::warn("Stored resolutions : read failed at entry {}/{}, skipping the rest", i, count);
+					break;
+				}
+
+				if (!a_intfc->ResolveFormID(formID, formID) || !a_intfc->ResolveFormID(resolution.base, resolution.base)) {
+					continue;
+				}
+				if (manager->AddResolution(formID, resolution)) {
+					++numLoaded;
+				}
+			}
+
+			logger::info("Loaded {}/{} stored resolutions", numLoaded, count);
+		}
+	}
+
+	void RevertCallback(SKSE::SerializationInterface*)
+	{
+		Manager::GetSingleton()->ClearResolutions();
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// per-reference lock resolutions, stored in the co-save (bPersistResolutions)
+namespace Serialization
+{
+	inline constexpr std::uint32_t kSerializationVersion = 1;
+	inline constexpr std::uint32_t kUniqueID = 'LVAR';
+	inline constexpr std::uint32_t kResolutions = 'RSLV';
+
+	void Register();
+
+	void SaveCallback(SKSE::SerializationInterface* a_intfc);
+	void LoadCallback(SKSE::SerializationInterface* a_intfc);
+	void RevertCallback(SKSE::SerializationInterface* a_intfc);
+}
@@ -0,0 +1,31 @@
+#include "Settings.h"
+
+void Settings::Load()
+{
+	const auto path = fmt::format("Data/SKSE/Plugins/{}.ini", Version::PROJECT);
+
+	logger::info("{:*^30}", "SETTINGS");
+
+	CSimpleIniA ini;
+	ini.SetUnicode();
+
+	if (const auto rc = ini.LoadFile(path.c_str()); rc < 0) {
+		logger::info("\tNo settings file found, using defaults");
+	} else {
+		ini::get_value(ini, loadRuntimeConfigs, "General", "bLoadRuntimeConfigs");
+		ini::get_value(ini, persistResolutions, "General", "bPersistResolutions");
+		ini::get_value(ini, preResolveOnCellLoad, "General", "bPreResolveOnCellLoad");
+		ini::get_value(ini, resolveBudget, "General", "iResolveBudgetUs");
+		ini::get_value(ini, matchTelemetry, "Debug", "bMatchTelemetry");
+		ini::get_value(ini, profileStartup, "Debug", "bProfileStartup");
+	}
+
+#ifdef EMBEDDED_CONFIGS
+	logger::info("Load runtime configs : {}", loadRuntimeConfigs);
+#endif
+	logger::info("Persist resolutions : {}", persistResolutions);
+	logger::info("Pre-resolve on cell load : {}", preResolveOnCellLoad);
+	logger::info("Resolve budget : {}", resolveBudget ? fmt::format("{}us", resolveBudget) : "off"s);
+	logger::info("Match telemetry : {}", matchTelemetry);
+	logger::info("Profile startup : {}", profileStartup);
+}
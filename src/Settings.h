@@ -0,0 +1,15 @@
+#pragma once
+
+class Settings : public ISingleton<Settings>
+{
+public:
+	void Load();
+
+	// members
+	bool          loadRuntimeConfigs{ false };    // builds with embedded configs only: also read _LID files from Data
+	bool          persistResolutions{ false };    // store resolved references in the co-save
+	bool          preResolveOnCellLoad{ false };  // resolve every locked reference in a cell as it finishes loading
+	std::uint32_t resolveBudget{ 0 };             // microseconds a lock opening may spend resolving before falling back, 0 to disable
+	bool          matchTelemetry{ false };        // count how often each variant/model is evaluated and matched
+	bool          profileStartup{ false };        // per-section startup spans and a Chrome trace next to the log
+};
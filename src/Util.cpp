@@ -1,56 +1,162 @@
 #include "Util.h"
+#include "Arena.h"
 
 namespace util
 {
-	RE::FormID GetFormID(const std::string& a_str)
+	namespace detail
 	{
-		if (const auto splitID = string::split(a_str, "~"); splitID.size() == 2) {
-			const auto  formID = string::to_num<RE::FormID>(splitID[0], true);
-			const auto& modName = splitID[1];
-			if (g_mergeMapperInterface) {
-				const auto [mergedModName, mergedFormID] = g_mergeMapperInterface->GetNewFormID(modName.c_str(), formID);
-				return RE::TESDataHandler::GetSingleton()->LookupFormID(mergedFormID, mergedModName);
-			} else {
-				return RE::TESDataHandler::GetSingleton()->LookupFormID(formID, modName);
+		template <class String>
+		String sanitize_path(std::string_view a_path, const srell::regex& a_prefix, String a_result)
+		{
+			static const srell::regex slashes("/+|\\\\+");
+			static const srell::regex leading("^\\\\+");
+
+			std::pmr::string lower(a_path, Arena::Get());
+			std::ranges::transform(lower, lower.begin(), [](unsigned char a_ch) { return static_cast<char>(std::tolower(a_ch)); });
+
+			std::pmr::string collapsed(Arena::Get());
+			srell::regex_replace(std::back_inserter(collapsed), lower.begin(), lower.end(), slashes, "\\");
+
+			std::pmr::string trimmed(Arena::Get());
+			srell::regex_replace(std::back_inserter(trimmed), collapsed.begin(), collapsed.end(), leading, "");
+
+			srell::regex_replace(std::back_inserter(a_result), trimmed.begin(), trimmed.end(), a_prefix, "");
+			return a_result;
+		}
+
+		const srell::regex& model_prefix()
+		{
+			static const srell::regex prefix(R"(.*?[^\s]meshes\\|^meshes\\)", srell::regex::icase);
+			return prefix;
+		}
+
+		// hex, with or without the 0x prefix, like string::to_num<RE::FormID>(str, true)
+		RE::FormID to_formID(std::string_view a_str)
+		{
+			if (a_str.starts_with("0x") || a_str.starts_with("0X")) {
+				a_str.remove_prefix(2);
 			}
+			RE::FormID formID{};
+			std::from_chars(a_str.data(), a_str.data() + a_str.size(), formID, 16);
+			return formID;
 		}
-		if (string::is_only_hex(a_str, true)) {
-			return string::to_num<RE::FormID>(a_str, true);
+	}
+
+	std::string SanitizeTexture(std::string_view a_path)
+	{
+		static const srell::regex prefix(R"(.*?[^\s]textures\\|^textures\\)", srell::regex::icase);
+		return detail::sanitize_path(a_path, prefix, std::string());
+	}
+
+	std::string SanitizeModel(std::string_view a_path)
+	{
+		return detail::sanitize_path(a_path, detail::model_prefix(), std::string());
+	}
+
+	std::pmr::string SanitizeModel(std::string_view a_path, std::pmr::memory_resource* a_resource)
+	{
+		return detail::sanitize_path(a_path, detail::model_prefix(), std::pmr::string(a_resource));
+	}
+
+	bool is_valid_entry(std::string_view a_str)
+	{
+		return !a_str.empty() && !string::iequals(a_str, "NONE"sv);
+	}
+
+	std::pmr::vector<std::string_view> split(std::string_view a_str, std::string_view a_delimiter)
+	{
+		std::pmr::vector<std::string_view> result(Arena::Get());
+		for (std::size_t pos = 0;;) {
+			const auto next = a_str.find(a_delimiter, pos);
+			result.push_back(a_str.substr(pos, next == std::string_view::npos ? std::string_view::npos : next - pos));
+			if (next == std::string_view::npos) {
+				break;
+			}
+			pos = next + a_delimiter.size();
 		}
-		if (const auto form = RE::TESForm::LookupByEditorID(a_str)) {
-			return form->GetFormID();
+		return result;
+	}
+
+	FormIDResolver::FormIDResolver() :
+		formIDs(Arena::Get()),
+		mergedFormIDs(Arena::Get())
+	{}
+
+	void FormIDResolver::Add(std::string_view a_str)
+	{
+		++numRequests;
+		if (!formIDs.contains(a_str)) {
+			formIDs.emplace(std::pmr::string(a_str, formIDs.get_allocator()), 0);
 		}
-		return static_cast<RE::FormID>(0);
 	}
 
-	FormIDStr GetFormIDStr(const std::string& a_str, bool a_sanitizePath)
+	void FormIDResolver::Resolve()
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		std::size_t numResolved = 0;
+		for (auto& [str, formID] : formIDs) {
+			formID = ResolveImpl(str);
+			if (formID != 0) {
+				++numResolved;
+			}
+		}
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		logger::info("Resolved {} identifiers ({} unresolved, {} duplicates skipped) in {}us", numResolved, formIDs.size() - numResolved, numRequests - formIDs.size(), elapsed.count());
+	}
+
+	RE::FormID FormIDResolver::GetFormID(std::string_view a_str) const
+	{
+		const auto it = formIDs.find(a_str);
+		return it != formIDs.end() ? it->second : static_cast<RE::FormID>(0);
+	}
+
+	FormIDStr FormIDResolver::GetFormIDStr(std::string_view a_str, bool a_sanitizePath) const
 	{
 		auto formID = GetFormID(a_str);
 		if (formID != 0) {
 			return formID;
 		}
-		return a_sanitizePath ? SanitizeTexture(a_str) : a_str;
+		return a_sanitizePath ? SanitizeTexture(a_str) : std::string(a_str);
 	}
 
-	std::string SanitizeTexture(const std::string& a_path)
+	RE::FormID FormIDResolver::ResolveImpl(std::string_view a_str)
 	{
-		auto path = string::tolower(a_path);
-
-		path = srell::regex_replace(path, srell::regex("/+|\\\\+"), "\\");
-		path = srell::regex_replace(path, srell::regex("^\\\\+"), "");
-		path = srell::regex_replace(path, srell::regex(R"(.*?[^\s]textures\\|^textures\\)", srell::regex::icase), "");
-
-		return path;
+		if (const auto splitID = split(a_str, "~"); splitID.size() == 2) {
+			const auto formID = detail::to_formID(splitID[0]);
+			const auto modName = splitID[1];
+			if (g_mergeMapperInterface) {
+				return ResolveMerged(modName, formID);
+			} else {
+				return RE::TESDataHandler::GetSingleton()->LookupFormID(formID, modName);
+			}
+		}
+		if (string::is_only_hex(a_str, true)) {
+			return detail::to_formID(a_str);
+		}
+		if (const auto form = RE::TESForm::LookupByEditorID(a_str)) {
+			return form->GetFormID();
+		}
+		return static_cast<RE::FormID>(0);
 	}
 
-	std::string SanitizeModel(const std::string& a_path)
+	RE::FormID FormIDResolver::ResolveMerged(std::string_view a_modName, RE::FormID a_formID)
 	{
-		auto path = string::tolower(a_path);
+		auto it = mergedFormIDs.find(a_modName);
+		if (it == mergedFormIDs.end()) {
+			it = mergedFormIDs.try_emplace(std::pmr::string(a_modName, mergedFormIDs.get_allocator())).first;
+		}
+
+		auto& [modName, pluginFormIDs] = *it;
+		if (const auto formIt = pluginFormIDs.find(a_formID); formIt != pluginFormIDs.end()) {
+			return formIt->second;
+		}
 
-		path = srell::regex_replace(path, srell::regex("/+|\\\\+"), "\\");
-		path = srell::regex_replace(path, srell::regex("^\\\\+"), "");
-		path = srell::regex_replace(path, srell::regex(R"(.*?[^\s]meshes\\|^meshes\\)", srell::regex::icase), "");
+		const auto [mergedModName, mergedFormID] = g_mergeMapperInterface->GetNewFormID(modName.c_str(), a_formID);  // the map key is null terminated, the view may not be
+		const auto formID = RE::TESDataHandler::GetSingleton()->LookupFormID(mergedFormID, mergedModName);
 
-		return path;
+		pluginFormIDs.emplace(a_formID, formID);
+		return formID;
 	}
 }
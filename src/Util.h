@@ -2,8 +2,45 @@
 
 namespace util
 {
-	RE::FormID  GetFormID(const std::string& a_str);
-	FormIDStr   GetFormIDStr(const std::string& a_str, bool a_sanitizePath = false);
-	std::string SanitizeModel(const std::string& a_path);
-	std::string SanitizeTexture(const std::string& a_path);
+	std::string      SanitizeModel(std::string_view a_path);
+	std::pmr::string SanitizeModel(std::string_view a_path, std::pmr::memory_resource* a_resource);
+	std::string      SanitizeTexture(std::string_view a_path);
+
+	// dist::is_valid_entry, without copying into a std::string
+	bool is_valid_entry(std::string_view a_str);
+
+	// views into a_str, allocated from the load arena
+	std::pmr::vector<std::string_view> split(std::string_view a_str, std::string_view a_delimiter);
+
+	struct string_hash
+	{
+		using is_transparent = void;
+
+		std::size_t operator()(std::string_view a_str) const { return std::hash<std::string_view>{}(a_str); }
+	};
+
+	// collects config identifiers, then resolves each unique one once
+	class FormIDResolver
+	{
+	public:
+		FormIDResolver();
+
+		void Add(std::string_view a_str);
+		void Resolve();
+
+		[[nodiscard]] RE::FormID GetFormID(std::string_view a_str) const;
+		[[nodiscard]] FormIDStr  GetFormIDStr(std::string_view a_str, bool a_sanitizePath = false) const;
+
+	private:
+		template <class T>
+		using string_map = std::pmr::unordered_map<std::pmr::string, T, string_hash, std::equal_to<>>;
+
+		RE::FormID ResolveImpl(std::string_view a_str);
+		RE::FormID ResolveMerged(std::string_view a_modName, RE::FormID a_formID);
+
+		// members
+		string_map<RE::FormID>                                     formIDs;
+		string_map<std::pmr::unordered_map<RE::FormID, RE::FormID>> mergedFormIDs;  // per plugin
+		std::size_t                                                numRequests{};
+	};
 }
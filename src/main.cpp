@@ -1,5 +1,8 @@
+#include "API.h"
 #include "Hooks.h"
 #include "Manager.h"
+#include "Serialization.h"
+#include "Settings.h"
 
 void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 {
@@ -25,7 +28,16 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 		}
 		break;
 	case SKSE::MessagingInterface::kDataLoaded:
-		Manager::GetSingleton()->InitLockForms();
+		Manager::GetSingleton()->InitLockFormsAsync();
+		Manager::GetSingleton()->RegisterPreResolve();
+		std::atexit([] { Manager::GetSingleton()->DumpTelemetry(); });
+		break;
+	case SKSE::MessagingInterface::kPreLoadGame:
+	case SKSE::MessagingInterface::kNewGame:
+		Manager::GetSingleton()->ClearResolutions();
+		break;
+	case SKSE::MessagingInterface::kSaveGame:
+		Manager::GetSingleton()->DumpTelemetry();
 		break;
 	default:
 		break;
@@ -101,8 +113,13 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* a_s
 
 	logger::info("Game version : {}", a_skse->RuntimeVersion().string());
 
+	Settings::GetSingleton()->Load();
+
 	const auto messaging = SKSE::GetMessagingInterface();
 	messaging->RegisterListener(MessageHandler);
 
+	API::Register();
+	Serialization::Register();
+
 	return true;
 }
@@ -0,0 +1,222 @@
+#include "LIDParser.h"
+
+// Compares LID::Parse against CSimpleIni (as configured by Manager::ValidateParse) on random _LID-like inputs,
+// then times both parsers on the same corpus.
+//
+//	LIDParserFuzz [iterations] [seed]
+
+namespace
+{
+	using clock = std::chrono::steady_clock;
+
+	class Generator
+	{
+	public:
+		explicit Generator(std::uint32_t a_seed) :
+			rng(a_seed)
+		{}
+
+		std::string Generate()
+		{
+			std::string text;
+			if (chance(0.3)) {
+				text += "\xEF\xBB\xBF";
+			}
+			if (chance(0.5)) {
+				line(text, ";4.0.0");
+			}
+
+			const auto numLines = pick(0, 60);
+			for (std::size_t i = 0; i < numLines; ++i) {
+				switch (pick(0, 11)) {
+				case 0:
+				case 1:
+					line(text, spaces() + "[" + spaces() + section() + spaces() + "]" + spaces() + (chance(0.2) ? "; trailing" : ""));
+					break;
+				case 2:
+					line(text, "[" + section());  // unterminated
+					break;
+				case 3:
+					line(text, spaces() + (chance(0.5) ? ";" : "#") + word(0, 12));
+					break;
+				case 4:
+					line(text, spaces() + key());  // no '='
+					break;
+				case 5:
+					line(text, spaces() + "=" + spaces() + value());  // empty key
+					break;
+				case 6:
+					line(text, "");
+					break;
+				case 7:
+					{
+						// multi-key, same key (in any case) repeated with different values
+						const auto name = key();
+						for (std::size_t j = pick(2, 4); j > 0; --j) {
+							line(text, recase(name) + spaces() + "=" + spaces() + value());
+						}
+					}
+					break;
+				default:
+					line(text, spaces() + key() + spaces() + "=" + spaces() + value() + spaces());
+					break;
+				}
+			}
+
+			// sometimes no final newline
+			if (!text.empty() && chance(0.3)) {
+				text.pop_back();
+			}
+
+			return text;
+		}
+
+	private:
+		bool chance(double a_probability) { return std::bernoulli_distribution(a_probability)(rng); }
+
+		std::size_t pick(std::size_t a_min, std::size_t a_max) { return std::uniform_int_distribution<std::size_t>(a_min, a_max)(rng); }
+
+		void line(std::string& a_text, const std::string& a_line)
+		{
+			static constexpr std::array newlines{ "\n"sv, "\r\n"sv, "\r"sv, "\n\r"sv };
+			a_text += a_line;
+			a_text += newlines[pick(0, newlines.size() - 1)];
+		}
+
+		std::string spaces()
+		{
+			static constexpr std::array whitespace{ ' ', ' ', '\t' };
+			std::string result;
+			for (std::size_t i = chance(0.6) ? 0 : pick(1, 3); i > 0; --i) {
+				result += whitespace[pick(0, whitespace.size() - 1)];
+			}
+			return result;
+		}
+
+		std::string word(std::size_t a_min, std::size_t a_max)
+		{
+			static constexpr std::string_view chars{ "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_.\\/|~,:;#[] " };
+			std::string result;
+			for (std::size_t i = pick(a_min, a_max); i > 0; --i) {
+				result += chars[pick(0, chars.size() - 1)];
+			}
+			return result;
+		}
+
+		std::string recase(std::string a_str)
+		{
+			for (auto& c : a_str) {
+				if (chance(0.3)) {
+					c = static_cast<char>(c >= 'a' && c <= 'z' ? c - 'a' + 'A' : (c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c));
+				}
+			}
+			return a_str;
+		}
+
+		// small pools, so sections and keys collide (and differ only in case) often
+		std::string section()
+		{
+			static constexpr std::array names{ ""sv, "Meshes\\Clutter\\Chest01.nif"sv, "chest01.nif|WhiterunLocation"sv, "Door"sv, "Underwater"sv, "a b"sv };
+			return chance(0.8) ? recase(std::string(names[pick(0, names.size() - 1)])) : word(0, 16);
+		}
+
+		std::string key()
+		{
+			static constexpr std::array keys{ "Chest"sv, "Door"sv, "Lockpick"sv, "Chest|0x10FD5E~Skyrim.esm"sv, "Door|NONE|underwater"sv, "CylinderStop"sv };
+			return chance(0.8) ? recase(std::string(keys[pick(0, keys.size() - 1)])) : word(1, 16);
+		}
+
+		std::string value()
+		{
+			return chance(0.1) ? std::string() : word(0, 40);
+		}
+
+		// members
+		std::mt19937 rng;
+	};
+
+	std::string escape(std::string_view a_str)
+	{
+		std::string result;
+		for (const auto c : a_str) {
+			switch (c) {
+			case '\r':
+				result += "\\r";
+				break;
+			case '\n':
+				result += "\\n\n";
+				break;
+			case '\t':
+				result += "\\t";
+				break;
+			default:
+				result += c;
+				break;
+			}
+		}
+		return result;
+	}
+
+	std::pmr::vector<LID::Section> ParseSimpleIni(CSimpleIniA& a_ini, const std::string& a_text)
+	{
+		a_ini.Reset();
+		a_ini.SetUnicode();
+		a_ini.SetMultiKey();
+		a_ini.LoadData(a_text.data(), a_text.size());
+		return LID::Parse(a_ini);
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	const std::size_t   iterations = a_argc > 1 ? std::stoul(a_argv[1]) : 20000;
+	const std::uint32_t seed = a_argc > 2 ? static_cast<std::uint32_t>(std::stoul(a_argv[2])) : 0x4C4944;
+
+	Generator generator(seed);
+
+	std::vector<std::string> corpus;
+	corpus.reserve(iterations);
+	for (std::size_t i = 0; i < iterations; ++i) {
+		corpus.push_back(generator.Generate());
+	}
+
+	std::size_t numFailed = 0;
+	for (std::size_t i = 0; i < corpus.size(); ++i) {
+		CSimpleIniA ini;
+
+		const auto expected = ParseSimpleIni(ini, corpus[i]);
+		const auto actual = LID::Parse(corpus[i]);
+
+		if (!std::ranges::equal(expected, actual)) {
+			if (++numFailed <= 5) {
+				std::cout << "mismatch in input " << i << " (seed " << seed << ") : " << actual.size() << " sections, CSimpleIni has " << expected.size() << "\n"
+						  << escape(corpus[i]) << "\n---\n";
+			}
+		}
+	}
+
+	// same corpus through both, CSimpleIni as the plugin used it before the mapped parser
+	const auto time = [&](auto&& a_parse) {
+		std::size_t numSections = 0;
+		const auto  start = clock::now();
+		for (auto& text : corpus) {
+			numSections += a_parse(text);
+		}
+		return std::make_pair(std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start), numSections);
+	};
+
+	const auto [simpleIniTime, simpleIniSections] = time([](const std::string& a_text) {
+		CSimpleIniA ini;
+		return ParseSimpleIni(ini, a_text).size();
+	});
+	const auto [parserTime, parserSections] = time([](const std::string& a_text) {
+		std::pmr::monotonic_buffer_resource arena;
+		return LID::Parse(a_text, &arena).size();
+	});
+
+	std::cout << iterations << " inputs, " << numFailed << " mismatches\n"
+			  << "CSimpleIni : " << simpleIniTime.count() << "us (" << simpleIniSections << " sections)\n"
+			  << "LID::Parse : " << parserTime.count() << "us (" << parserSections << " sections)\n";
+
+	return numFailed == 0 ? 0 : 1;
+}
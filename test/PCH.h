@@ -0,0 +1,24 @@
+#pragma once
+
+// standalone stand-in for src/PCH.h, just what LIDParser.cpp needs without CommonLib
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <SimpleIni.h>
+
+using namespace std::literals;